@@ -0,0 +1,243 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-6 20:31:55
+@Description: 将二进制 trace 回放到 RRIP 缓存的命令行工具
+@Language: C++17
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include "../include/trace/trace_reader.h"
+#include "../include/SRRIP/srrip_cache.h"
+#include "../include/DRRIP/drrip_cache.h"
+#include "../include/hierarchy/cache_hierarchy.h"
+#include "../src/BRRIP/brrip_cache.h"
+
+struct Options {
+    std::string trace_path;
+    std::string policy = "srrip";
+    size_t cache_size_kb = 1024;
+    size_t block_size = 64;
+    size_t associativity = 16;
+    size_t threads = 1;
+    bool compact = false;
+    // 多级模式：每个 --level 追加一级，从 L1 开始
+    std::vector<std::string> levels;
+    std::string inclusion = "nine";
+};
+
+void printUsage(const char* prog) {
+    std::cerr << "用法: " << prog << " <trace 文件> [选项]\n"
+              << "  trace 为小端 uint64_t 地址序列，.gz / .zst 结尾时流式解压\n"
+              << "  --policy srrip|brrip|drrip   替换策略（默认 srrip）\n"
+              << "  --size-kb N                  缓存大小 KB（默认 1024）\n"
+              << "  --block N                    块大小字节（默认 64）\n"
+              << "  --ways N                     相联度（默认 16）\n"
+              << "  --threads N                  SRRIP/BRRIP 按组并行回放的线程数，0 为硬件并发数（默认 1）\n"
+              << "  --compact                    仅元数据缓存行\n"
+              << "  --level POLICY:SIZE_KB:WAYS  追加一级缓存（lru|srrip|brrip），给出时按多级层次回放\n"
+              << "  --inclusion inclusive|exclusive|nine  多级包含策略（默认 nine）\n";
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--policy") {
+            opts.policy = value();
+        } else if (arg == "--size-kb") {
+            opts.cache_size_kb = std::stoull(value());
+        } else if (arg == "--block") {
+            opts.block_size = std::stoull(value());
+        } else if (arg == "--ways") {
+            opts.associativity = std::stoull(value());
+        } else if (arg == "--threads") {
+            opts.threads = std::stoull(value());
+        } else if (arg == "--level") {
+            opts.levels.push_back(value());
+        } else if (arg == "--inclusion") {
+            opts.inclusion = value();
+        } else if (arg == "--compact") {
+            opts.compact = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::invalid_argument("unknown option " + arg);
+        } else if (opts.trace_path.empty()) {
+            opts.trace_path = arg;
+        } else {
+            throw std::invalid_argument("unexpected argument " + arg);
+        }
+    }
+    if (opts.trace_path.empty()) {
+        throw std::invalid_argument("missing trace file");
+    }
+    return opts;
+}
+
+// SRRIP/BRRIP 支持按组并行回放，批次之间顺序执行，保证每组内访问顺序不变；
+// 工作线程由缓存持有，在批次之间复用
+template <typename Cache>
+auto replayBatch(Cache& cache, const uint64_t* batch, size_t n, size_t threads, int)
+    -> decltype(cache.replay(batch, n, threads), void()) {
+    cache.replay(batch, n, threads);
+}
+
+template <typename Cache>
+void replayBatch(Cache& cache, const uint64_t* batch, size_t n, size_t, long) {
+    for (size_t i = 0; i < n; ++i) {
+        cache.access(batch[i]);
+    }
+}
+
+template <typename Cache>
+void run(const Options& opts) {
+    Cache cache(opts.cache_size_kb, opts.block_size, opts.associativity);
+    auto reader = Trace::openTrace(opts.trace_path);
+
+    auto start = std::chrono::steady_clock::now();
+    const uint64_t* batch = nullptr;
+    size_t n;
+    while ((n = reader->nextBatch(batch)) > 0) {
+        replayBatch(cache, batch, n, opts.threads, 0);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const uint64_t total = cache.getHitCount() + cache.getMissCount();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "策略: " << opts.policy << (opts.compact ? " (compact)" : "") << std::endl;
+    std::cout << "访问次数: " << total << std::endl;
+    std::cout << "命中次数: " << cache.getHitCount() << std::endl;
+    std::cout << "未命中次数: " << cache.getMissCount() << std::endl;
+    std::cout << "替换次数: " << cache.getReplaceCount() << std::endl;
+    std::cout << "命中率: " << cache.getHitRate() << "%" << std::endl;
+    std::cout << "耗时: " << std::fixed << std::setprecision(3) << seconds << " 秒";
+    if (seconds > 0) {
+        std::cout << " (" << std::setprecision(2) << total / seconds / 1e6 << " M accesses/sec)";
+    }
+    std::cout << std::endl;
+}
+
+std::unique_ptr<Hierarchy::CacheLevel> makeLevel(const std::string& spec, size_t index, const Options& opts) {
+    // POLICY:SIZE_KB:WAYS
+    auto first = spec.find(':');
+    auto second = spec.find(':', first == std::string::npos ? first : first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+        throw std::invalid_argument("level spec must be POLICY:SIZE_KB:WAYS: " + spec);
+    }
+    const std::string policy = spec.substr(0, first);
+    const size_t size_kb = std::stoull(spec.substr(first + 1, second - first - 1));
+    const size_t ways = std::stoull(spec.substr(second + 1));
+    const std::string name = "L" + std::to_string(index + 1);
+
+    if (policy == "lru") {
+        return std::make_unique<Hierarchy::LRULevel>(name, size_kb, opts.block_size, ways);
+    }
+    if (policy == "srrip") {
+        if (opts.compact) {
+            return std::make_unique<Hierarchy::SRRIPLevel<2, true>>(name, size_kb, opts.block_size, ways);
+        }
+        return std::make_unique<Hierarchy::SRRIPLevel<2>>(name, size_kb, opts.block_size, ways);
+    }
+    if (policy == "brrip") {
+        if (opts.compact) {
+            return std::make_unique<Hierarchy::BRRIPLevel<2, true>>(name, size_kb, opts.block_size, ways);
+        }
+        return std::make_unique<Hierarchy::BRRIPLevel<2>>(name, size_kb, opts.block_size, ways);
+    }
+    throw std::invalid_argument("unknown level policy " + policy);
+}
+
+void runHierarchy(const Options& opts) {
+    Hierarchy::InclusionPolicy inclusion;
+    if (opts.inclusion == "inclusive") {
+        inclusion = Hierarchy::InclusionPolicy::Inclusive;
+    } else if (opts.inclusion == "exclusive") {
+        inclusion = Hierarchy::InclusionPolicy::Exclusive;
+    } else if (opts.inclusion == "nine") {
+        inclusion = Hierarchy::InclusionPolicy::NINE;
+    } else {
+        throw std::invalid_argument("unknown inclusion policy " + opts.inclusion);
+    }
+
+    std::vector<std::unique_ptr<Hierarchy::CacheLevel>> levels;
+    for (size_t i = 0; i < opts.levels.size(); ++i) {
+        levels.push_back(makeLevel(opts.levels[i], i, opts));
+    }
+    Hierarchy::CacheHierarchy hierarchy(std::move(levels), inclusion);
+    auto reader = Trace::openTrace(opts.trace_path);
+
+    auto start = std::chrono::steady_clock::now();
+    const uint64_t* batch = nullptr;
+    size_t n;
+    uint64_t total = 0;
+    while ((n = reader->nextBatch(batch)) > 0) {
+        for (size_t i = 0; i < n; ++i) {
+            hierarchy.access(batch[i]);
+        }
+        total += n;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "包含策略: " << opts.inclusion << std::endl;
+    std::cout << "访问次数: " << total << std::endl;
+    std::cout << std::setw(6) << "级别" << std::setw(14) << "访问" << std::setw(14) << "命中"
+              << std::setw(14) << "未命中" << std::setw(10) << "未命中率"
+              << std::setw(12) << "写回" << std::setw(12) << "反向失效" << std::endl;
+    for (size_t i = 0; i < hierarchy.numLevels(); ++i) {
+        auto stats = hierarchy.getLevelStats(i);
+        std::cout << std::setw(6) << hierarchy.level(i).name()
+                  << std::setw(14) << stats.accesses << std::setw(14) << stats.hits
+                  << std::setw(14) << stats.misses
+                  << std::setw(9) << std::fixed << std::setprecision(2) << stats.missRate() * 100 << "%"
+                  << std::setw(12) << stats.writebacks << std::setw(12) << stats.back_invalidations << std::endl;
+    }
+    std::cout << "内存读取: " << hierarchy.getMemoryReads() << std::endl;
+    std::cout << "内存写回: " << hierarchy.getMemoryWritebacks() << std::endl;
+    std::cout << "端到端未命中率: " << std::setprecision(2) << hierarchy.getGlobalMissRate() * 100 << "%" << std::endl;
+    std::cout << "耗时: " << std::setprecision(3) << std::chrono::duration<double>(end - start).count() << " 秒" << std::endl;
+}
+
+template <template <uint8_t, bool> class Cache>
+void dispatch(const Options& opts) {
+    if (opts.compact) {
+        run<Cache<2, true>>(opts);
+    } else {
+        run<Cache<2, false>>(opts);
+    }
+}
+
+int main(int argc, char** argv) {
+    try {
+        Options opts = parseOptions(argc, argv);
+        if (!opts.levels.empty()) {
+            runHierarchy(opts);
+        } else if (opts.policy == "srrip") {
+            dispatch<SRRIP::SRRIPCache>(opts);
+        } else if (opts.policy == "brrip") {
+            dispatch<BRRIP::BRRIPCache>(opts);
+        } else if (opts.policy == "drrip") {
+            dispatch<DRRIP::DRRIPCache>(opts);
+        } else {
+            throw std::invalid_argument("unknown policy " + opts.policy);
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << "错误: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
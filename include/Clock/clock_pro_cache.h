@@ -0,0 +1,417 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 19:05:12
+@Description: Clock-Pro缓存: 热/冷/测试三指针共用一个环, 以CLOCK近似LIRS的重用距离
+@Language: C++17
+*/
+
+#ifndef CLOCK_PRO_CACHE_H
+#define CLOCK_PRO_CACHE_H
+
+#include "../utils/node.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+/*
+ * CLOCK-Pro (Jiang, Chen, Zhang 2005) keeps LIRS's reuse-distance test but
+ * runs it with clock hands over one circular list, so a hit is just a
+ * reference bit. Pages are
+ *   hot              resident, is_in_protected          (LIR in LIRS terms)
+ *   cold             resident, !is_in_protected         (resident HIR)
+ *   test             !is_resident, metadata only        (non-resident HIR)
+ * A cold page starts a test period when it enters the list, and keeps it
+ * (irr_value != 0) until HAND_hot or HAND_test passes it. Reuse inside the
+ * period means a reuse distance shorter than the oldest hot page's, so the
+ * page turns hot; a test page dropping out of its period is forgotten.
+ * HAND_hot turns unreferenced hot pages cold to keep the hot set at
+ * capacity - cold_target. cold_target adapts: reuse in a test period grows
+ * it, a period ending unused shrinks it. It stays within 1% of either end,
+ * like LIRS's HIR share; with almost no cold pages HAND_cold would circle
+ * the whole ring for each eviction. It starts at the low end and, as in
+ * LIRS, new pages go straight in hot while the hot set has room: starting
+ * all cold, the first pass over a loop past capacity ends in test hits
+ * that push cold_target up, and the hot set never settles.
+ *
+ * New pages go in right behind HAND_hot, the list head, which every hand
+ * reaches last.
+ */
+template <typename K, typename V, typename Hash = std::hash<std::string>>
+class ClockProCache {
+public:
+    explicit ClockProCache(size_t capacity);
+    ~ClockProCache();
+
+    ClockProCache(const ClockProCache&) = delete;
+    ClockProCache& operator=(const ClockProCache&) = delete;
+
+    void put(const K& key, const V& value);
+    bool get(const K& key, V& value) const;
+    bool contains(const K& key) const;
+    void remove(const K& key);
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+    void clear();
+
+    // page counts by state, and the adaptive cold-page target
+    size_t hot_size() const;
+    size_t cold_size() const;
+    size_t test_size() const;
+    size_t cold_target() const;
+
+private:
+    using NodeT = Node<K, V>;
+
+    static bool isHot(const NodeT* node) { return node->is_in_protected; }
+    static bool isCold(const NodeT* node) { return node->is_resident && !node->is_in_protected; }
+    static bool isTest(const NodeT* node) { return !node->is_resident; }
+    static bool inTestPeriod(const NodeT* node) { return node->irr_value != 0; }
+
+    // hits only hold the shared lock, so the bit is written atomically
+    static void markReferenced(NodeT* node);
+
+    // caller holds mutex_ exclusively
+    void addPage(const K& key, const V& value, bool hot);
+    void deletePage(NodeT* node);
+    void moveToHead(NodeT* node);
+    void growColdTarget();
+    void shrinkColdTarget();
+    // end a cold page's test period, dropping it if it is a test page
+    void endTestPeriod(NodeT* node);
+    void evict();
+    void runHandCold();
+    void runHandHot();
+    void runHandTest();
+
+private:
+    size_t capacity_;
+    size_t min_cold_;
+    size_t cold_target_;
+    size_t count_hot_;
+    size_t count_cold_;
+    size_t count_test_;
+
+    std::unordered_map<K, NodeT*, Hash> keyToNode_;
+    NodeT* hand_hot_;   // also the list head: new pages are linked just before it
+    NodeT* hand_cold_;
+    NodeT* hand_test_;
+
+    mutable std::shared_mutex mutex_;
+};
+
+template <typename K, typename V, typename Hash>
+ClockProCache<K, V, Hash>::ClockProCache(size_t capacity)
+    : capacity_(capacity), min_cold_(std::max<size_t>(1, capacity / 100)), cold_target_(min_cold_),
+      count_hot_(0), count_cold_(0), count_test_(0),
+      hand_hot_(nullptr), hand_cold_(nullptr), hand_test_(nullptr) {
+    if (capacity_ == 0) {
+        throw std::invalid_argument("Capacity must be greater than 0");
+    }
+    keyToNode_.reserve(2 * capacity_);
+}
+
+template <typename K, typename V, typename Hash>
+ClockProCache<K, V, Hash>::~ClockProCache() {
+    clear();
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    for (auto& [key, node] : keyToNode_) {
+        delete node;
+    }
+    keyToNode_.clear();
+    hand_hot_ = hand_cold_ = hand_test_ = nullptr;
+    count_hot_ = count_cold_ = count_test_ = 0;
+    cold_target_ = min_cold_;
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::markReferenced(NodeT* node) {
+#if defined(__GNUC__) || defined(__clang__)
+    if (__atomic_load_n(&node->clock_bit, __ATOMIC_RELAXED) == 0) {
+        __atomic_store_n(&node->clock_bit, 1, __ATOMIC_RELAXED);
+    }
+#else
+    node->clock_bit = 1;
+#endif
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::put(const K& key, const V& value) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = keyToNode_.find(key);
+    if (it == keyToNode_.end()) {
+        /* first sight: a cold page on test, or hot while the hot set has room */
+        addPage(key, value, count_hot_ + cold_target_ < capacity_);
+        return;
+    }
+
+    NodeT* node = it->second;
+    if (node->is_resident) {
+        node->value = value;
+        node->clock_bit = 1;
+        return;
+    }
+
+    /* test hit: reuse distance below the oldest hot page's */
+    growColdTarget();
+    deletePage(node);
+    --count_test_;
+    addPage(key, value, true);
+}
+
+template <typename K, typename V, typename Hash>
+bool ClockProCache<K, V, Hash>::get(const K& key, V& value) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = keyToNode_.find(key);
+    if (it == keyToNode_.end() || !it->second->is_resident) {
+        return false;
+    }
+    value = it->second->value;
+    markReferenced(it->second);
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool ClockProCache<K, V, Hash>::contains(const K& key) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = keyToNode_.find(key);
+    return it != keyToNode_.end() && it->second->is_resident;
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::remove(const K& key) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = keyToNode_.find(key);
+    if (it == keyToNode_.end()) {
+        return;
+    }
+    NodeT* node = it->second;
+    if (isHot(node)) {
+        --count_hot_;
+    } else if (isCold(node)) {
+        --count_cold_;
+    } else {
+        --count_test_;
+    }
+    deletePage(node);
+}
+
+template <typename K, typename V, typename Hash>
+size_t ClockProCache<K, V, Hash>::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return count_hot_ + count_cold_;
+}
+
+template <typename K, typename V, typename Hash>
+size_t ClockProCache<K, V, Hash>::hot_size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return count_hot_;
+}
+
+template <typename K, typename V, typename Hash>
+size_t ClockProCache<K, V, Hash>::cold_size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return count_cold_;
+}
+
+template <typename K, typename V, typename Hash>
+size_t ClockProCache<K, V, Hash>::test_size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return count_test_;
+}
+
+template <typename K, typename V, typename Hash>
+size_t ClockProCache<K, V, Hash>::cold_target() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return cold_target_;
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::addPage(const K& key, const V& value, bool hot) {
+    evict();
+
+    NodeT* node = new NodeT(key, value, 0);
+    node->clock_bit = 0;
+    node->is_resident = true;
+    node->is_in_protected = hot;
+    node->irr_value = hot ? 0 : 1;
+
+    if (hand_hot_ == nullptr) {
+        node->next = node;
+        node->prev = node;
+        hand_hot_ = hand_cold_ = hand_test_ = node;
+    } else {
+        node->next = hand_hot_;
+        node->prev = hand_hot_->prev;
+        node->prev->next = node;
+        hand_hot_->prev = node;
+    }
+    keyToNode_[key] = node;
+
+    if (hot) {
+        ++count_hot_;
+    } else {
+        ++count_cold_;
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::deletePage(NodeT* node) {
+    if (node->next == node) {
+        hand_hot_ = hand_cold_ = hand_test_ = nullptr;
+    } else {
+        // hands on the page move on to its successor
+        if (hand_hot_ == node) {
+            hand_hot_ = node->next;
+        }
+        if (hand_cold_ == node) {
+            hand_cold_ = node->next;
+        }
+        if (hand_test_ == node) {
+            hand_test_ = node->next;
+        }
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+    }
+    keyToNode_.erase(node->key);
+    delete node;
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::moveToHead(NodeT* node) {
+    if (node == hand_hot_ || node->next == hand_hot_) {
+        return;  // already at the head
+    }
+    if (hand_cold_ == node) {
+        hand_cold_ = node->next;
+    }
+    if (hand_test_ == node) {
+        hand_test_ = node->next;
+    }
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = hand_hot_;
+    node->prev = hand_hot_->prev;
+    node->prev->next = node;
+    hand_hot_->prev = node;
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::growColdTarget() {
+    if (cold_target_ + min_cold_ < capacity_) {
+        ++cold_target_;
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::shrinkColdTarget() {
+    if (cold_target_ > min_cold_) {
+        --cold_target_;
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::endTestPeriod(NodeT* node) {
+    shrinkColdTarget();
+    if (isTest(node)) {
+        deletePage(node);
+        --count_test_;
+    } else {
+        node->irr_value = 0;
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::evict() {
+    while (count_hot_ + count_cold_ >= capacity_) {
+        runHandCold();
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::runHandCold() {
+    // step past the page first: it may move to the head or be retired below
+    NodeT* node = hand_cold_;
+    hand_cold_ = node->next;
+    if (isCold(node)) {
+        if (node->clock_bit) {
+            node->clock_bit = 0;
+            if (inTestPeriod(node)) {
+                /* reused within its test period: promote to a hot page at the head */
+                growColdTarget();
+                node->irr_value = 0;
+                node->is_in_protected = true;
+                --count_cold_;
+                ++count_hot_;
+                moveToHead(node);
+            } else {
+                /* reused too late: another test period from the head */
+                node->irr_value = 1;
+                moveToHead(node);
+            }
+        } else if (inTestPeriod(node)) {
+            /* evict, keep the metadata until the test period ends */
+            node->is_resident = false;
+            node->value = V();
+            --count_cold_;
+            ++count_test_;
+            while (count_test_ > capacity_) {
+                runHandTest();
+            }
+        } else {
+            --count_cold_;
+            deletePage(node);
+        }
+    }
+    while (count_hot_ > capacity_ - cold_target_) {
+        runHandHot();
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::runHandHot() {
+    // HAND_hot never passes HAND_test: test periods end before the hot scan
+    if (hand_hot_ == hand_test_) {
+        runHandTest();
+    }
+    NodeT* node = hand_hot_;
+    hand_hot_ = node->next;
+    if (isHot(node)) {
+        if (node->clock_bit) {
+            node->clock_bit = 0;
+        } else {
+            node->is_in_protected = false;
+            --count_hot_;
+            ++count_cold_;
+        }
+    } else if (inTestPeriod(node)) {
+        /* older than every hot page now: the test period is over */
+        endTestPeriod(node);
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ClockProCache<K, V, Hash>::runHandTest() {
+    // likewise HAND_test never passes HAND_cold
+    if (hand_test_ == hand_cold_) {
+        runHandCold();
+    }
+    NodeT* node = hand_test_;
+    hand_test_ = node->next;
+    if (!isHot(node) && inTestPeriod(node)) {
+        endTestPeriod(node);
+    }
+}
+
+#endif
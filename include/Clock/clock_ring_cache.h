@@ -0,0 +1,269 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 18:48:02
+@Description: 数组环形Clock/Sieve缓存, 槽位按插入顺序排列, 访问位压缩为位图, 指针用tzcnt按64位字扫描
+@Language: C++17
+*/
+
+#ifndef CLOCK_RING_CACHE_H
+#define CLOCK_RING_CACHE_H
+
+#include "../utils/bit_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// CLOCK and SIEVE over a fixed array of slots instead of a list of nodes.
+// Occupancy and reference bits live in parallel packed bitmaps, so the hand
+// looks at 64 slots per word: the next victim is the lowest bit of
+// occupied & ~referenced, and every slot passed on the way loses its
+// reference bit with a single mask.
+//
+// Slots are kept in insertion order, oldest first, and the hand moves
+// towards the newest one, then wraps to the oldest. With mark_on_insert =
+// true (ClockCache) a newcomer takes the victim's slot, right behind the
+// hand, and is spared once. With false (SIEVE) a newcomer is appended after
+// the newest slot, as SIEVE inserts at the head of its queue: the hand
+// reaches it before wrapping back to the older survivors, and it must be
+// hit once to survive that pass. Evicted slots are left as holes in the
+// order, and when appending runs out of slots the survivors are compacted
+// to the front, keeping their order; the array has capacity / 2 spare
+// slots, so compaction costs O(1) per insertion amortized.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class ClockRingCache {
+public:
+    explicit ClockRingCache(size_t capacity, bool mark_on_insert = false);
+    ~ClockRingCache() = default;
+
+    void put(const K& key, const V& value);
+    bool get(const K& key, V& value) const;
+    bool contains(const K& key) const;
+    void remove(const K& key);
+    size_t size() const;
+    size_t capacity() const { return capacity_; }
+    void clear();
+
+private:
+    static constexpr size_t BITS_PER_WORD = 64;
+
+    // caller holds mutex_ exclusively and the ring is full
+    uint32_t findVictim();
+    // caller holds mutex_ exclusively; moves live slots to the front in order
+    void compact();
+    void moveSlot(size_t from, size_t to);
+
+    static void setBit(std::vector<uint64_t>& bits, size_t slot) { bits[slot / BITS_PER_WORD] |= 1ULL << (slot % BITS_PER_WORD); }
+    static void clearBit(std::vector<uint64_t>& bits, size_t slot) { bits[slot / BITS_PER_WORD] &= ~(1ULL << (slot % BITS_PER_WORD)); }
+
+private:
+    size_t capacity_;
+    size_t slots_;   // capacity plus spare slots for appending
+    size_t words_;
+    bool mark_on_insert_;
+
+    std::vector<K> keys_;
+    std::vector<V> values_;
+    std::vector<uint64_t> occupied_;
+    // hits set bits under the shared lock, so these are atomic
+    std::unique_ptr<std::atomic<uint64_t>[]> referenced_;
+    std::unordered_map<K, uint32_t, Hash> keyToSlot_;
+
+    size_t head_;   // slots [0, head_) are in use or holes, head_ is the next append
+    size_t hand_;
+    mutable std::shared_mutex mutex_;
+};
+
+template <typename K, typename V, typename Hash>
+ClockRingCache<K, V, Hash>::ClockRingCache(size_t capacity, bool mark_on_insert)
+    : capacity_(capacity),
+      slots_(capacity + std::max<size_t>(capacity / 2, 1)),
+      words_((slots_ + BITS_PER_WORD - 1) / BITS_PER_WORD),
+      mark_on_insert_(mark_on_insert),
+      head_(0),
+      hand_(0) {
+    if (capacity_ == 0 || capacity_ > UINT32_MAX / 2) {
+        throw std::invalid_argument("Capacity must be in [1, 2^31)");
+    }
+    keys_.resize(slots_);
+    values_.resize(slots_);
+    occupied_.assign(words_, 0);
+    referenced_ = std::make_unique<std::atomic<uint64_t>[]>(words_);
+    keyToSlot_.reserve(capacity_);
+    clear();
+}
+
+template <typename K, typename V, typename Hash>
+void ClockRingCache<K, V, Hash>::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    keyToSlot_.clear();
+    std::fill(occupied_.begin(), occupied_.end(), 0);
+    for (size_t w = 0; w < words_; ++w) {
+        referenced_[w].store(0, std::memory_order_relaxed);
+    }
+    head_ = 0;
+    hand_ = 0;
+}
+
+template <typename K, typename V, typename Hash>
+uint32_t ClockRingCache<K, V, Hash>::findVictim() {
+    // At most one full turn clears every reference bit, so the second turn
+    // is bound to stop; the extra word covers starting mid-word. Slots at
+    // and past head_ are never occupied.
+    size_t pos = hand_;
+    for (size_t step = 0; step <= 2 * words_; ++step) {
+        const size_t word = pos / BITS_PER_WORD;
+        const uint64_t from_hand = ~0ULL << (pos % BITS_PER_WORD);
+        const uint64_t referenced = referenced_[word].load(std::memory_order_relaxed);
+        const uint64_t candidates = occupied_[word] & ~referenced & from_hand;
+        if (candidates != 0) {
+            const unsigned bit = countTrailingZeros(candidates);
+            const uint64_t passed = from_hand & ((1ULL << bit) - 1);
+            referenced_[word].store(referenced & ~passed, std::memory_order_relaxed);
+            const size_t victim = word * BITS_PER_WORD + bit;
+            // past the newest slot the hand wraps to the oldest
+            hand_ = victim + 1 >= head_ ? 0 : victim + 1;
+            return static_cast<uint32_t>(victim);
+        }
+        // every occupied slot from the hand to the word's end was referenced
+        referenced_[word].store(referenced & ~from_hand, std::memory_order_relaxed);
+        pos = (word + 1) * BITS_PER_WORD;
+        if (pos >= head_) {
+            pos = 0;
+        }
+    }
+    throw std::logic_error("ClockRingCache: no victim in a full ring");
+}
+
+template <typename K, typename V, typename Hash>
+void ClockRingCache<K, V, Hash>::moveSlot(size_t from, size_t to) {
+    keys_[to] = std::move(keys_[from]);
+    values_[to] = std::move(values_[from]);
+    keyToSlot_[keys_[to]] = static_cast<uint32_t>(to);
+    const uint64_t referenced = referenced_[from / BITS_PER_WORD].load(std::memory_order_relaxed);
+    clearBit(occupied_, from);
+    setBit(occupied_, to);
+    if ((referenced >> (from % BITS_PER_WORD)) & 1) {
+        referenced_[from / BITS_PER_WORD].fetch_and(~(1ULL << (from % BITS_PER_WORD)), std::memory_order_relaxed);
+        referenced_[to / BITS_PER_WORD].fetch_or(1ULL << (to % BITS_PER_WORD), std::memory_order_relaxed);
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ClockRingCache<K, V, Hash>::compact() {
+    // the hand keeps pointing at the first live slot it had not reached yet
+    size_t next = 0;
+    size_t new_hand = 0;
+    bool hand_placed = false;
+    for (size_t slot = 0; slot < head_; ++slot) {
+        if (!hand_placed && slot >= hand_) {
+            new_hand = next;
+            hand_placed = true;
+        }
+        if ((occupied_[slot / BITS_PER_WORD] >> (slot % BITS_PER_WORD)) & 1) {
+            if (slot != next) {
+                moveSlot(slot, next);
+            }
+            ++next;
+        }
+    }
+    head_ = next;
+    hand_ = new_hand >= head_ ? 0 : new_hand;
+}
+
+template <typename K, typename V, typename Hash>
+void ClockRingCache<K, V, Hash>::put(const K& key, const V& value) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = keyToSlot_.find(key);
+    if (it != keyToSlot_.end()) {
+        const uint32_t slot = it->second;
+        values_[slot] = value;
+        referenced_[slot / BITS_PER_WORD].fetch_or(1ULL << (slot % BITS_PER_WORD), std::memory_order_relaxed);
+        return;
+    }
+
+    size_t slot = slots_;
+    if (keyToSlot_.size() == capacity_) {
+        const uint32_t victim = findVictim();
+        keyToSlot_.erase(keys_[victim]);
+        clearBit(occupied_, victim);
+        if (mark_on_insert_) {
+            slot = victim;  // CLOCK: the newcomer replaces the victim in place
+        }
+    }
+    if (slot == slots_) {
+        // SIEVE, or room left: append after the newest slot
+        if (head_ == slots_) {
+            compact();
+        }
+        slot = head_++;
+    }
+
+    keys_[slot] = key;
+    values_[slot] = value;
+    setBit(occupied_, slot);
+    const uint64_t bit = 1ULL << (slot % BITS_PER_WORD);
+    if (mark_on_insert_) {
+        referenced_[slot / BITS_PER_WORD].fetch_or(bit, std::memory_order_relaxed);
+    } else {
+        referenced_[slot / BITS_PER_WORD].fetch_and(~bit, std::memory_order_relaxed);
+    }
+    keyToSlot_.emplace(key, static_cast<uint32_t>(slot));
+}
+
+template <typename K, typename V, typename Hash>
+bool ClockRingCache<K, V, Hash>::get(const K& key, V& value) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+
+    auto it = keyToSlot_.find(key);
+    if (it == keyToSlot_.end()) {
+        return false;
+    }
+
+    const uint32_t slot = it->second;
+    value = values_[slot];
+    // readers of a hot word only write it when the bit is actually missing
+    std::atomic<uint64_t>& word = referenced_[slot / BITS_PER_WORD];
+    const uint64_t bit = 1ULL << (slot % BITS_PER_WORD);
+    if ((word.load(std::memory_order_relaxed) & bit) == 0) {
+        word.fetch_or(bit, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool ClockRingCache<K, V, Hash>::contains(const K& key) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return keyToSlot_.find(key) != keyToSlot_.end();
+}
+
+template <typename K, typename V, typename Hash>
+size_t ClockRingCache<K, V, Hash>::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return keyToSlot_.size();
+}
+
+template <typename K, typename V, typename Hash>
+void ClockRingCache<K, V, Hash>::remove(const K& key) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = keyToSlot_.find(key);
+    if (it == keyToSlot_.end()) {
+        return;
+    }
+
+    const uint32_t slot = it->second;
+    keyToSlot_.erase(it);
+    clearBit(occupied_, slot);
+    // the slot stays a hole until the next compaction
+    referenced_[slot / BITS_PER_WORD].fetch_and(~(1ULL << (slot % BITS_PER_WORD)), std::memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,50 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 21:01:07
+@Description: DRRIP缓存集实现（SRRIP/BRRIP 共用）
+@Language: C++17
+*/
+
+#ifndef DRRIP_CACHE_SET_H
+#define DRRIP_CACHE_SET_H
+
+#include "../SRRIP/cache_line.h"
+#include "../utils/rrip_cache_set.h"
+
+#include <cstdint>
+
+namespace DRRIP {
+
+using SRRIP::CacheLineType;
+
+// 插入策略：每次填充时由调用方决定
+enum class InsertionPolicy : uint8_t {
+    SRRIP,  // 插入 RRPV_MAX - 1
+    BRRIP,  // 以 1/32 概率插入 RRPV_MAX - 1，其余插入 RRPV_MAX
+};
+
+// METADATA_ONLY 为 true 时使用不含数据块的 CompactCacheLine。
+// 找牺牲者前整体老化，直到有行达到 RRPV_MAX
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY = false>
+class CacheSet : public RRIPCacheSet<CacheLineType<METADATA_ONLY>, RRPV_M_BITS, true> {
+    using Base = RRIPCacheSet<CacheLineType<METADATA_ONLY>, RRPV_M_BITS, true>;
+    static_assert(!METADATA_ONLY || RRPV_M_BITS <= 4, "CompactCacheLine stores RRPV in 4 bits");
+
+public:
+    // 构造函数，传入该组的相联度（路的数量）和组内随机数种子
+    using Base::Base;
+
+    // 按给定插入策略填充一个 way（未命中时调用）
+    void fillWay(size_t way_index, uint64_t tag, InsertionPolicy policy) {
+        if (policy == InsertionPolicy::SRRIP) {
+            Base::fillWay(way_index, tag, Base::RRPV_MAX - 1);
+        } else {
+            // epsilon = 1/32 的概率保留 RRPV_MAX - 1
+            Base::fillWayBimodal(way_index, tag, Base::RRPV_MAX, Base::RRPV_MAX - 1);
+        }
+    }
+};
+
+} // namespace DRRIP
+
+#endif // DRRIP_CACHE_SET_H
@@ -0,0 +1,92 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-2 21:30:02
+@Description: DRRIP主缓存（SRRIP/BRRIP 组竞争）
+@Language: C++17
+*/
+
+#ifndef DRRIP_CACHE_H
+#define DRRIP_CACHE_H
+
+#include "cache_set.h"
+
+#include <atomic>
+
+namespace DRRIP {
+
+// Set Dueling：一部分 leader 组固定使用 SRRIP，一部分固定使用 BRRIP，
+// leader 组的未命中驱动 PSEL 饱和计数器，follower 组根据 PSEL 选择插入策略
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY = false>
+class DRRIPCache {
+public:
+    static constexpr size_t DEFAULT_LEADER_SETS = 32;   // 每种策略的 leader 组数
+    static constexpr uint32_t PSEL_BITS = 10;
+    static constexpr uint32_t PSEL_MAX = (1u << PSEL_BITS) - 1;
+    static constexpr uint32_t PSEL_INIT = 1u << (PSEL_BITS - 1);
+
+    // 构造函数，定义缓存的几何结构和每种策略的 leader 组数；
+    // 组数须至少为 leader_sets 的 3 倍，否则没有 follower 组，抛出 std::invalid_argument
+    DRRIPCache(size_t cache_size_kb, size_t block_size_bytes, size_t associativity,
+               size_t leader_sets = DEFAULT_LEADER_SETS);
+
+    // 核心接口，访问一个内存地址，返回 true 表示命中， false 表示未命中
+    bool access(uint64_t address);
+
+    // 获取统计信息
+    [[nodiscard]] uint64_t getHitCount() const noexcept {
+        return hit_count_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] uint64_t getMissCount() const noexcept {
+        return miss_count_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] uint64_t getReplaceCount() const noexcept {
+        return replace_count_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t getHitRate() const noexcept;
+
+    // PSEL 当前值，>= PSEL_INIT 时 follower 组使用 BRRIP
+    [[nodiscard]] uint32_t getPsel() const noexcept {
+        return psel_.load(std::memory_order_relaxed);
+    }
+
+    // follower 组当前使用的插入策略
+    [[nodiscard]] InsertionPolicy getFollowerPolicy() const noexcept {
+        return getPsel() >= PSEL_INIT ? InsertionPolicy::BRRIP : InsertionPolicy::SRRIP;
+    }
+
+    // 地址解析辅助函数
+    void parseAddress(uint64_t address, uint64_t& tag, size_t& set_index) const;
+
+private:
+    enum class SetRole : uint8_t {
+        SRRIPLeader,
+        BRRIPLeader,
+        Follower,
+    };
+
+    [[nodiscard]] SetRole roleOf(size_t set_index) const noexcept;
+
+    // leader 组未命中时更新 PSEL（饱和）
+    void updatePsel(SetRole role) noexcept;
+
+    const size_t associativity_;
+    const size_t num_sets_;
+    const int offset_bits_;
+    const int set_index_bits_;
+    // 每隔 leader_stride_ 个组各取一个 SRRIP leader 和 BRRIP leader
+    size_t leader_stride_;
+
+    std::vector<CacheSet<RRPV_M_BITS, METADATA_ONLY>> sets_;
+
+    // SRRIP leader 未命中 +1，BRRIP leader 未命中 -1
+    std::atomic<uint32_t> psel_{PSEL_INIT};
+
+    std::atomic<uint64_t> hit_count_{0};
+    std::atomic<uint64_t> miss_count_{0};
+    std::atomic<uint64_t> replace_count_{0};
+};
+
+} // namespace DRRIP
+
+#endif // DRRIP_CACHE_H
@@ -1,6 +1,6 @@
 /*
 @Author: Lzww  
-@LastEditTime: 2025-8-23 21:22:36
+@LastEditTime: 2026-10-16 15:10:42
 @Description: GDSF Cache
 @Language: C++17
 */
@@ -8,10 +8,11 @@
 #ifndef GDSF_CACHE_H
 #define GDSF_CACHE_H
 
+#include "../utils/indexed_heap.h"
+
 #include <optional>
 #include <functional>
 #include <string>
-#include <set>
 #include <unordered_map>
 #include <shared_mutex>
 #include <memory>
@@ -53,33 +54,22 @@ private:
         size_t size;
         size_t frequency;
         double priority;
+        size_t heap_index;  // position in heap_
 
         Node(const K& key, const V& value, size_t size, double priority)
-            : key(key), value(value), size(size), frequency(1), priority(priority) {}
-    };
-
-    struct NodeComparator {
-        // allow comparison of different types
-        using is_transparent = void;
-
-        bool operator()(const Node& a, const Node& b) const {
-            if (a.priority != b.priority) {
-                return a.priority < b.priority;
-            }
-
-            return a.key < b.key;
-        }
+            : key(key), value(value), size(size), frequency(1), priority(priority), heap_index(0) {}
     };
 
-    using NodeSet = std::set<Node, NodeComparator>;
-    using NodeMap = std::unordered_map<K, typename NodeSet::iterator, Hash>;
-
     size_t capacity_;
     size_t current_size_;
     double l_value_;
 
-    NodeSet priority_queue_;
-    NodeMap lookup_table_;
+    // Nodes live in lookup_table_, whose elements never move. A heap
+    // entry keeps the priority its node had when last sifted: get() only
+    // raises node->priority and the entry catches up once it reaches the
+    // top (see evict()).
+    IndexedHeap<Node> heap_;
+    std::unordered_map<K, Node, Hash> lookup_table_;
 
     std::shared_mutex mtx_;
 };
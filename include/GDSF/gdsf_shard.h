@@ -0,0 +1,264 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 20:14:05
+@Description: GDSF缓存分片: 每分片独立的索引堆和L值, 字节预算在分片间共享
+@Language: C++17
+*/
+
+#ifndef GDSF_SHARD_H
+#define GDSF_SHARD_H
+
+#include "../utils/indexed_heap.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace GDSF {
+
+// One GDSF heap with its own inflation value L. L only follows the
+// evictions made from this shard, so a shard that is rarely chosen as the
+// victim keeps a low L, inserts at low priorities and is chosen sooner:
+// the shards' priority scales stay close without sharing L.
+//
+// Bytes are charged to a budget shared by all shards. When the budget has
+// no room, put() evicts from this shard only if the caller says this shard
+// is the victim; otherwise it fails and the caller evicts elsewhere before
+// retrying, so no thread ever holds two shard locks.
+template <typename K, typename V, typename Hash = std::hash<std::string>>
+class GDSFShard {
+public:
+    GDSFShard(std::atomic<size_t>& used, size_t budget, double l_value);
+
+    GDSFShard(const GDSFShard&) = delete;
+    GDSFShard& operator=(const GDSFShard&) = delete;
+
+    std::optional<V> get(const K& key);
+
+    // false when the bytes it needs are not free in the budget. With
+    // evict_self the key makes room here first; a key that grows is taken
+    // out of the heap meanwhile so it is never its own victim.
+    bool put(const K& key, const V& value, size_t size, bool evict_self = false);
+
+    bool remove(const K& key);
+
+    // evict the lowest priority entry, false when empty
+    bool evictOne();
+
+    // lowest priority in the shard, +inf when empty. Read without the lock
+    // for victim sampling; hits below the top since the last publish may
+    // have raised it, so it is a lower bound.
+    double min_priority() const { return min_priority_.load(std::memory_order_relaxed); }
+
+    bool contains(const K& key) const;
+    size_t size() const;
+    size_t count() const;
+    double l_value() const;
+
+private:
+    struct Node {
+        K key;
+        V value;
+        size_t size;
+        size_t frequency;
+        double priority;
+        size_t heap_index;
+
+        Node(const K& key, const V& value, size_t size, double priority)
+            : key(key), value(value), size(size), frequency(1), priority(priority), heap_index(0) {}
+    };
+
+    // caller holds mtx_ exclusively
+    double calculate_priority(size_t frequency, size_t size) const;
+    bool reserve(size_t bytes);
+    void evictLocked();
+    // bring the top entry up to date and publish it as min_priority_
+    void publishMin();
+
+private:
+    mutable std::shared_mutex mtx_;
+    std::unordered_map<K, Node, Hash> lookup_table_;
+    IndexedHeap<Node> heap_;
+    size_t current_size_ = 0;
+    double l_value_;
+
+    std::atomic<double> min_priority_{std::numeric_limits<double>::infinity()};
+    std::atomic<size_t>& used_;
+    size_t budget_;
+};
+
+template <typename K, typename V, typename Hash>
+GDSFShard<K, V, Hash>::GDSFShard(std::atomic<size_t>& used, size_t budget, double l_value)
+    : l_value_(l_value), used_(used), budget_(budget) {}
+
+template <typename K, typename V, typename Hash>
+double GDSFShard<K, V, Hash>::calculate_priority(size_t frequency, size_t size) const {
+    return l_value_ + static_cast<double>(frequency) / size;
+}
+
+template <typename K, typename V, typename Hash>
+bool GDSFShard<K, V, Hash>::reserve(size_t bytes) {
+    if (used_.fetch_add(bytes, std::memory_order_relaxed) + bytes > budget_) {
+        used_.fetch_sub(bytes, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+void GDSFShard<K, V, Hash>::publishMin() {
+    // the same lazy catch-up as GDSFCache::evict(): a hit only raised the
+    // node's priority, the entry is re-keyed when it surfaces
+    while (!heap_.empty() && heap_.top().priority < heap_.top().node->priority) {
+        heap_.update(0, heap_.top().node->priority);
+    }
+    min_priority_.store(heap_.empty() ? std::numeric_limits<double>::infinity() : heap_.top().priority,
+                        std::memory_order_relaxed);
+}
+
+template <typename K, typename V, typename Hash>
+std::optional<V> GDSFShard<K, V, Hash>::get(const K& key) {
+    std::lock_guard<std::shared_mutex> lock(mtx_);
+
+    auto it = lookup_table_.find(key);
+    if (it == lookup_table_.end()) {
+        return std::nullopt;
+    }
+
+    Node& node = it->second;
+    node.frequency++;
+    node.priority = calculate_priority(node.frequency, node.size);
+    if (node.heap_index == 0) {
+        // the top was hit, so the shard minimum went up: republish it
+        // or victim sampling keeps picking this shard
+        publishMin();
+    }
+    return node.value;
+}
+
+template <typename K, typename V, typename Hash>
+bool GDSFShard<K, V, Hash>::put(const K& key, const V& value, size_t size, bool evict_self) {
+    std::lock_guard<std::shared_mutex> lock(mtx_);
+
+    auto existing_it = lookup_table_.find(key);
+    if (existing_it != lookup_table_.end()) {
+        Node& node = existing_it->second;
+        if (size > node.size && !reserve(size - node.size)) {
+            if (!evict_self) {
+                return false;
+            }
+            // the same as GDSFCache::put: out of the heap while making room
+            heap_.remove(node.heap_index);
+            while (!reserve(size - node.size)) {
+                if (heap_.empty()) {
+                    heap_.push(&node, node.priority);
+                    publishMin();
+                    return false;
+                }
+                evictLocked();
+            }
+            heap_.push(&node, node.priority);
+        }
+        if (size < node.size) {
+            used_.fetch_sub(node.size - size, std::memory_order_relaxed);
+        }
+        current_size_ = current_size_ - node.size + size;
+        node.value = value;
+        node.size = size;
+        node.priority = calculate_priority(node.frequency, size);
+        heap_.update(node.heap_index, node.priority);
+        publishMin();
+        return true;
+    }
+
+    while (!reserve(size)) {
+        if (!evict_self || heap_.empty()) {
+            publishMin();
+            return false;
+        }
+        evictLocked();
+    }
+    auto it = lookup_table_.try_emplace(key, key, value, size, calculate_priority(1, size)).first;
+    heap_.push(&it->second, it->second.priority);
+    current_size_ += size;
+    publishMin();
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool GDSFShard<K, V, Hash>::remove(const K& key) {
+    std::lock_guard<std::shared_mutex> lock(mtx_);
+
+    auto it = lookup_table_.find(key);
+    if (it == lookup_table_.end()) {
+        return false;
+    }
+
+    current_size_ -= it->second.size;
+    used_.fetch_sub(it->second.size, std::memory_order_relaxed);
+    heap_.remove(it->second.heap_index);
+    lookup_table_.erase(it);
+    publishMin();
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool GDSFShard<K, V, Hash>::evictOne() {
+    std::lock_guard<std::shared_mutex> lock(mtx_);
+
+    if (heap_.empty()) {
+        return false;
+    }
+    evictLocked();
+    publishMin();
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+void GDSFShard<K, V, Hash>::evictLocked() {
+    // settle the lazily keyed top first, then it is the shard minimum
+    while (heap_.top().priority < heap_.top().node->priority) {
+        heap_.update(0, heap_.top().node->priority);
+    }
+
+    Node* victim = heap_.top().node;
+    l_value_ = victim->priority;
+    current_size_ -= victim->size;
+    used_.fetch_sub(victim->size, std::memory_order_relaxed);
+    heap_.remove(0);
+    lookup_table_.erase(lookup_table_.find(victim->key));
+}
+
+template <typename K, typename V, typename Hash>
+bool GDSFShard<K, V, Hash>::contains(const K& key) const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return lookup_table_.find(key) != lookup_table_.end();
+}
+
+template <typename K, typename V, typename Hash>
+size_t GDSFShard<K, V, Hash>::size() const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return current_size_;
+}
+
+template <typename K, typename V, typename Hash>
+size_t GDSFShard<K, V, Hash>::count() const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return lookup_table_.size();
+}
+
+template <typename K, typename V, typename Hash>
+double GDSFShard<K, V, Hash>::l_value() const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return l_value_;
+}
+
+} // namespace GDSF
+
+#endif // GDSF_SHARD_H
@@ -0,0 +1,307 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 20:31:47
+@Description: 采样淘汰GDSF缓存: 条目存于扁平数组, 淘汰时随机采样K个取优先级最低者, 支持Hyperbolic优先级
+@Language: C++17
+*/
+
+#ifndef GDSF_SAMPLED_CACHE_H
+#define GDSF_SAMPLED_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace GDSF {
+
+enum class PriorityMode {
+    GDSF,        // L + frequency / size, L raised to each victim's priority
+    Hyperbolic,  // frequency / (time in cache * size), no aging value
+};
+
+// GDSF without an ordered structure. Entries sit in a flat array and the
+// map points at their slot; a hit only bumps the entry's counters. An
+// eviction draws `samples` random slots, as Redis does for maxmemory, and
+// like Redis keeps the best candidates seen so far in a small pool sorted
+// by priority: the victim is the pool's lowest entry, so low-priority keys
+// sampled by earlier evictions are not forgotten. A hit only changes the
+// entry, so pooled priorities are re-read at every eviction before new
+// samples join the pool; the pool is a handful of keys, which keeps the
+// hit path free of any reordering.
+//
+// Hyperbolic caching (Blankstein et al., ATC '17) ranks by access rate
+// since insertion instead, frequency / time in cache, divided by size as
+// in the paper's size-aware variant. A rate can only be compared at one
+// instant, which an exact heap cannot keep ordered but sampling evaluates
+// on the spot, and the same re-ranking of the pool keeps pooled rates
+// current as the clock moves. Time is a logical clock of cache operations.
+template <typename K, typename V, typename Hash = std::hash<std::string>>
+class SampledGDSFCache {
+public:
+    explicit SampledGDSFCache(size_t capacity, PriorityMode mode = PriorityMode::GDSF, size_t samples = 5,
+                              double l_value = 0.5);
+
+    bool put(const K& key, const V& value, size_t size);
+
+    [[nodiscard]] std::optional<V> get(const K& key);
+
+    bool remove(const K& key);
+
+    [[nodiscard]] bool contains(const K& key) const;
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+
+    [[nodiscard]] size_t count() const;
+
+    [[nodiscard]] PriorityMode mode() const { return mode_; }
+
+private:
+    struct Entry {
+        K key;
+        V value;
+        size_t size;
+        size_t frequency;
+        double priority;       // GDSF: H value as of the last access
+        uint64_t inserted_at;  // Hyperbolic: logical time of insertion
+
+        Entry(const K& key, const V& value, size_t size, double priority, uint64_t inserted_at)
+            : key(key), value(value), size(size), frequency(1), priority(priority), inserted_at(inserted_at) {}
+    };
+
+    struct PoolEntry {
+        K key;
+        double priority;
+    };
+
+    static constexpr size_t EVICTION_POOL_SIZE = 16;
+
+    // caller holds mtx_ exclusively
+    double calculate_priority(size_t frequency, size_t size) const;
+    double evictionPriority(const Entry& entry) const;
+    // recompute pooled priorities as of now, drop gone keys
+    void refreshPool();
+    void populatePool();
+    // slot of the best pool candidate still cached, or entries_.size()
+    size_t popPool();
+    void evict(size_t needed_space);
+    // swap the last slot into the hole
+    void eraseSlot(size_t slot);
+
+private:
+    size_t capacity_;
+    size_t current_size_;
+    double l_value_;
+    PriorityMode mode_;
+    size_t samples_;
+    uint64_t clock_;
+
+    std::vector<Entry> entries_;
+    std::unordered_map<K, size_t, Hash> lookup_table_;
+    std::vector<PoolEntry> pool_;  // ascending priority
+    std::mt19937_64 rng_;
+
+    mutable std::shared_mutex mtx_;
+};
+
+template <typename K, typename V, typename Hash>
+SampledGDSFCache<K, V, Hash>::SampledGDSFCache(size_t capacity, PriorityMode mode, size_t samples, double l_value)
+    : capacity_(capacity), current_size_(0), l_value_(l_value), mode_(mode), samples_(samples == 0 ? 1 : samples),
+      clock_(0), rng_(0x9e3779b97f4a7c15ULL) {}
+
+template <typename K, typename V, typename Hash>
+double SampledGDSFCache<K, V, Hash>::calculate_priority(size_t frequency, size_t size) const {
+    return l_value_ + static_cast<double>(frequency) / size;
+}
+
+template <typename K, typename V, typename Hash>
+double SampledGDSFCache<K, V, Hash>::evictionPriority(const Entry& entry) const {
+    if (mode_ == PriorityMode::GDSF) {
+        return entry.priority;
+    }
+    // +1: an entry inserted by this very operation has been in for one tick
+    double age = static_cast<double>(clock_ - entry.inserted_at + 1);
+    return static_cast<double>(entry.frequency) / (age * entry.size);
+}
+
+template <typename K, typename V, typename Hash>
+void SampledGDSFCache<K, V, Hash>::refreshPool() {
+    size_t kept = 0;
+    for (size_t i = 0; i < pool_.size(); ++i) {
+        auto it = lookup_table_.find(pool_[i].key);
+        if (it == lookup_table_.end()) {
+            continue;
+        }
+        pool_[kept] = pool_[i];
+        pool_[kept].priority = evictionPriority(entries_[it->second]);
+        ++kept;
+    }
+    pool_.resize(kept);
+    // insertion sort, the pool is a handful of entries
+    for (size_t i = 1; i < pool_.size(); ++i) {
+        for (size_t j = i; j > 0 && pool_[j].priority < pool_[j - 1].priority; --j) {
+            std::swap(pool_[j], pool_[j - 1]);
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void SampledGDSFCache<K, V, Hash>::populatePool() {
+    // with no more entries than samples look at each one; keys already
+    // pooled were re-ranked by refreshPool()
+    const size_t n = entries_.size();
+    const bool exhaustive = n <= samples_;
+    for (size_t i = 0; i < (exhaustive ? n : samples_); ++i) {
+        const Entry& entry = entries_[exhaustive ? i : rng_() % n];
+        double priority = evictionPriority(entry);
+        if (pool_.size() == EVICTION_POOL_SIZE && !(priority < pool_.back().priority)) {
+            continue;
+        }
+        bool pooled = false;
+        for (const PoolEntry& candidate : pool_) {
+            if (candidate.key == entry.key) {
+                pooled = true;
+                break;
+            }
+        }
+        if (pooled) {
+            continue;
+        }
+        if (pool_.size() == EVICTION_POOL_SIZE) {
+            pool_.pop_back();
+        }
+        // insertion sort, the pool is a handful of entries
+        auto pos = pool_.begin();
+        while (pos != pool_.end() && !(priority < pos->priority)) {
+            ++pos;
+        }
+        pool_.insert(pos, PoolEntry{entry.key, priority});
+    }
+}
+
+template <typename K, typename V, typename Hash>
+size_t SampledGDSFCache<K, V, Hash>::popPool() {
+    while (!pool_.empty()) {
+        auto it = lookup_table_.find(pool_.front().key);
+        pool_.erase(pool_.begin());
+        if (it != lookup_table_.end()) {
+            return it->second;
+        }
+    }
+    return entries_.size();
+}
+
+template <typename K, typename V, typename Hash>
+void SampledGDSFCache<K, V, Hash>::eraseSlot(size_t slot) {
+    current_size_ -= entries_[slot].size;
+    lookup_table_.erase(entries_[slot].key);
+    if (slot + 1 != entries_.size()) {
+        entries_[slot] = std::move(entries_.back());
+        lookup_table_[entries_[slot].key] = slot;
+    }
+    entries_.pop_back();
+}
+
+template <typename K, typename V, typename Hash>
+void SampledGDSFCache<K, V, Hash>::evict(size_t needed_space) {
+    while (current_size_ + needed_space > capacity_ && !entries_.empty()) {
+        refreshPool();
+        populatePool();
+        size_t victim = popPool();
+        if (victim == entries_.size()) {
+            continue;  // every pooled key was gone, sample again
+        }
+        if (mode_ == PriorityMode::GDSF) {
+            // core: the sampled minimum stands in for the true one
+            l_value_ = entries_[victim].priority;
+        }
+        eraseSlot(victim);
+    }
+}
+
+template <typename K, typename V, typename Hash>
+bool SampledGDSFCache<K, V, Hash>::put(const K& key, const V& value, size_t size) {
+    std::lock_guard<std::shared_mutex> lock(mtx_);
+
+    if (size > capacity_) {
+        return false;
+    }
+    ++clock_;
+
+    size_t frequency = 1;
+    uint64_t inserted_at = clock_;
+    auto existing_it = lookup_table_.find(key);
+    if (existing_it != lookup_table_.end()) {
+        // an update keeps its history but leaves the array while room is made
+        frequency = entries_[existing_it->second].frequency;
+        inserted_at = entries_[existing_it->second].inserted_at;
+        eraseSlot(existing_it->second);
+    }
+
+    evict(size);
+
+    entries_.emplace_back(key, value, size, calculate_priority(frequency, size), inserted_at);
+    entries_.back().frequency = frequency;
+    lookup_table_[key] = entries_.size() - 1;
+    current_size_ += size;
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+std::optional<V> SampledGDSFCache<K, V, Hash>::get(const K& key) {
+    std::lock_guard<std::shared_mutex> lock(mtx_);
+
+    ++clock_;
+    auto it = lookup_table_.find(key);
+    if (it == lookup_table_.end()) {
+        return std::nullopt;
+    }
+
+    // nothing to reorder: the counters are read when the entry is sampled
+    Entry& entry = entries_[it->second];
+    entry.frequency++;
+    entry.priority = calculate_priority(entry.frequency, entry.size);
+    return entry.value;
+}
+
+template <typename K, typename V, typename Hash>
+bool SampledGDSFCache<K, V, Hash>::remove(const K& key) {
+    std::lock_guard<std::shared_mutex> lock(mtx_);
+
+    auto it = lookup_table_.find(key);
+    if (it == lookup_table_.end()) {
+        return false;
+    }
+    eraseSlot(it->second);
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool SampledGDSFCache<K, V, Hash>::contains(const K& key) const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return lookup_table_.find(key) != lookup_table_.end();
+}
+
+template <typename K, typename V, typename Hash>
+size_t SampledGDSFCache<K, V, Hash>::size() const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return current_size_;
+}
+
+template <typename K, typename V, typename Hash>
+size_t SampledGDSFCache<K, V, Hash>::count() const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return entries_.size();
+}
+
+} // namespace GDSF
+
+#endif // GDSF_SAMPLED_CACHE_H
@@ -0,0 +1,193 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 20:14:05
+@Description: 分片GDSF缓存: 分片各自维护堆和L, 淘汰时从k个随机分片的最小值中选受害者
+@Language: C++17
+*/
+
+#ifndef GDSF_SHARDED_CACHE_H
+#define GDSF_SHARDED_CACHE_H
+
+#include "gdsf_shard.h"
+#include "../utils/bit_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace GDSF {
+
+// GDSF split into power-of-two shards, each with its own heap, L and lock,
+// under one byte budget. When the budget is full an insert compares its own
+// shard with k - 1 random others and evicts the minimum of the one whose
+// minimum is lowest (power-of-k choices). The sample reads each shard's
+// published minimum without locking it, so a miss locks only its own shard
+// and, when the victim is elsewhere, the victim's. k = 2 already lands
+// close to the global minimum.
+template <typename K, typename V, typename Hash = std::hash<std::string>>
+class ShardedGDSFCache {
+public:
+    // shard_count 0 picks 2x hardware threads, rounded to a power of two;
+    // sample_shards is clamped to [1, shard_count]
+    explicit ShardedGDSFCache(size_t capacity, size_t shard_count = 0, double l_value = 0.5,
+                              size_t sample_shards = 2);
+    ~ShardedGDSFCache() = default;
+
+    // false only when size exceeds the whole capacity
+    bool put(const K& key, const V& value, size_t size);
+
+    [[nodiscard]] std::optional<V> get(const K& key);
+
+    bool remove(const K& key);
+
+    [[nodiscard]] bool contains(const K& key) const;
+
+    // bytes in use
+    [[nodiscard]] size_t size() const { return used_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+
+    [[nodiscard]] size_t count() const;
+
+    size_t shard_count() const { return shard_count_; }
+    const GDSFShard<K, V, Hash>& shard(size_t index) const { return *shards_[index]; }
+
+private:
+    size_t getShard(const K& key) const;
+
+    // self, or the shard with the lowest minimum among self and
+    // sample_shards - 1 random others
+    size_t pickVictim(size_t self) const;
+
+    // the shard other than `except` with the lowest minimum,
+    // shard_count_ when all of them are empty
+    size_t lowestOther(size_t except) const;
+
+private:
+    std::atomic<size_t> used_{0};
+    size_t capacity_;
+    size_t shard_count_;
+    size_t sample_shards_;
+    std::vector<std::unique_ptr<GDSFShard<K, V, Hash>>> shards_;
+    Hash hasher_;
+};
+
+template <typename K, typename V, typename Hash>
+ShardedGDSFCache<K, V, Hash>::ShardedGDSFCache(size_t capacity, size_t shard_count, double l_value,
+                                               size_t sample_shards)
+    : capacity_(capacity) {
+    if (capacity_ == 0) {
+        throw std::invalid_argument("Capacity must be greater than 0");
+    }
+    if (shard_count == 0) {
+        shard_count = std::thread::hardware_concurrency() * 2;
+    }
+    shard_count_ = nextPowerOf2(std::max<size_t>(shard_count, 1));
+    sample_shards_ = std::clamp<size_t>(sample_shards, 1, shard_count_);
+
+    shards_.reserve(shard_count_);
+    for (size_t i = 0; i < shard_count_; ++i) {
+        shards_.emplace_back(std::make_unique<GDSFShard<K, V, Hash>>(used_, capacity_, l_value));
+    }
+}
+
+template <typename K, typename V, typename Hash>
+size_t ShardedGDSFCache<K, V, Hash>::getShard(const K& key) const {
+    // mix the high bits in, std::hash is the identity for integers
+    size_t hash_val = hasher_(key);
+    hash_val ^= hash_val >> 17;
+    return hash_val & (shard_count_ - 1);
+}
+
+template <typename K, typename V, typename Hash>
+size_t ShardedGDSFCache<K, V, Hash>::pickVictim(size_t self) const {
+    thread_local std::minstd_rand rng(static_cast<unsigned>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+
+    size_t victim = self;
+    double lowest = shards_[self]->min_priority();
+    for (size_t i = 1; i < sample_shards_; ++i) {
+        size_t candidate = rng() & (shard_count_ - 1);
+        double priority = shards_[candidate]->min_priority();
+        if (priority < lowest) {
+            lowest = priority;
+            victim = candidate;
+        }
+    }
+    return victim;
+}
+
+template <typename K, typename V, typename Hash>
+size_t ShardedGDSFCache<K, V, Hash>::lowestOther(size_t except) const {
+    size_t victim = shard_count_;
+    double lowest = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < shard_count_; ++i) {
+        double priority = shards_[i]->min_priority();
+        if (i != except && priority < lowest) {
+            lowest = priority;
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+template <typename K, typename V, typename Hash>
+bool ShardedGDSFCache<K, V, Hash>::put(const K& key, const V& value, size_t size) {
+    if (size > capacity_) {
+        return false;
+    }
+    const size_t self = getShard(key);
+    // Sample only when the budget looks full. A victim elsewhere is evicted
+    // without holding our lock, one entry per attempt; another insert may
+    // take the freed bytes, then we go again.
+    while (true) {
+        size_t victim = self;
+        if (used_.load(std::memory_order_relaxed) + size > capacity_) {
+            victim = pickVictim(self);
+        }
+        if (shards_[self]->put(key, value, size, victim == self)) {
+            return true;
+        }
+        if (victim == self || shards_[victim]->min_priority() == std::numeric_limits<double>::infinity()) {
+            // own shard ran dry, or the sampled one was emptied meanwhile:
+            // the lowest minimum anywhere else
+            victim = lowestOther(self);
+        }
+        if (victim == shard_count_ || !shards_[victim]->evictOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash>
+std::optional<V> ShardedGDSFCache<K, V, Hash>::get(const K& key) {
+    return shards_[getShard(key)]->get(key);
+}
+
+template <typename K, typename V, typename Hash>
+bool ShardedGDSFCache<K, V, Hash>::remove(const K& key) {
+    return shards_[getShard(key)]->remove(key);
+}
+
+template <typename K, typename V, typename Hash>
+bool ShardedGDSFCache<K, V, Hash>::contains(const K& key) const {
+    return shards_[getShard(key)]->contains(key);
+}
+
+template <typename K, typename V, typename Hash>
+size_t ShardedGDSFCache<K, V, Hash>::count() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard->count();
+    }
+    return total;
+}
+
+} // namespace GDSF
+
+#endif // GDSF_SHARDED_CACHE_H
@@ -16,6 +16,8 @@
 #include <mutex>
 #include <optional>
 #include <memory>
+#include <deque>
+#include <cstdint>
 
 constexpr size_t DEFAULT_CAPACITY = 1024 * 1024 * 100;
 
@@ -26,7 +28,8 @@ namespace LIRS {
 template <typename K, typename V, typename Hash = std::hash<std::string>>
 class LIRSCache {
 public:
-    LIRSCache(size_t capacity = DEFAULT_CAPACITY);
+    // max_ghosts bounds the non-resident history, 0 means 2x capacity
+    LIRSCache(size_t capacity = DEFAULT_CAPACITY, size_t max_ghosts = 0);
     ~LIRSCache();
     
     // core methods
@@ -38,7 +41,19 @@ public:
     bool empty() const;
     void clear();
 
+    // resident LIR / HIR block counts
+    size_t lir_size() const;
+    size_t hir_size() const;
+    // non-resident HIR records currently kept
+    size_t ghost_size() const;
+
 private:
+    /* non-resident HIR block: only the key hash and the recency it had in S */
+    struct GhostRecord {
+        size_t hash;
+        uint64_t recency;
+    };
+
     std::unordered_map<K, LIRSNode<K, V>*, Hash> key_to_node_;
     LIRSNode<K, V> *lir_head_;
     LIRSNode<K, V> *hir_head_;
@@ -48,18 +63,33 @@ private:
     size_t lir_size_;
     size_t hir_size_;
 
+    size_t lir_capacity_;
+
+    /* ghosts by key hash, and their insertion order for the size bound */
+    std::unordered_map<size_t, uint64_t> ghosts_;
+    std::deque<GhostRecord> ghost_fifo_;
+    size_t max_ghosts_;
+    uint64_t clock_;
+    Hash hasher_;
+
     mutable std::mutex mtx_;
 
+    /* S stack: top is lir_head_->next_s, bottom is lir_head_->prev_s */
     void push_to_s(LIRSNode<K, V> *node);
+    void remove_from_s(LIRSNode<K, V> *node);
+    /* Q queue: resident HIR blocks, evicted from the front, appended at the back */
     void push_to_q(LIRSNode<K, V> *node);
 
+    void access(LIRSNode<K, V> *node);
     void evict_victim();
     void prune_s_stack();
     void demote_lir_to_hir();
-    bool should_promote_to_lir(LIRSNode<K, V> *node, size_t hir_original_distance);
-    size_t get_distance_from_head(LIRSNode<K, V> *node);
+    LIRSNode<K, V>* find_node(const K& key) const;
 
-    bool contains(const K& key) const;
+    uint64_t bottom_recency() const;
+    void add_ghost(LIRSNode<K, V> *node);
+    bool take_ghost(const K& key);
+    void prune_ghosts();
 };
 
 } // namespace LIRS
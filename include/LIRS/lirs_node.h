@@ -9,6 +9,7 @@
 #define LIRS_NODE_H
 
 #include <cstdint>
+#include <utility>
 
 constexpr uint32_t MAX_IRR_VALUE = UINT32_MAX;
 
@@ -20,7 +21,9 @@ struct LIRSNode {
     V value;
     bool is_LIRS;
     bool is_resident;
+    bool in_s;          /* still in the S stack: a hit now has IRR below the oldest LIR */
     uint32_t irr_value;
+    uint64_t recency;   /* stamp of the last push to S, grows towards the top */
 
     LIRSNode *prev_s, *next_s;
     LIRSNode *prev_q, *next_q;
@@ -35,7 +38,7 @@ struct LIRSNode {
 
 template <typename K, typename V>
 LIRSNode<K, V>::LIRSNode(const K& k, const V& v)
-    : key(std::move(k)), value(std::move(v)), is_LIRS(false), is_resident(true), irr_value(MAX_IRR_VALUE),
+    : key(std::move(k)), value(std::move(v)), is_LIRS(false), is_resident(true), in_s(false), irr_value(MAX_IRR_VALUE), recency(0),
       prev_s(nullptr), next_s(nullptr), prev_q(nullptr), next_q(nullptr) {}
 
 template <typename K, typename V>
@@ -9,10 +9,11 @@
 #define CACHE_LINE_H
 
 #include <cstdint>
+#include <type_traits>
 
 namespace SRRIP {
 
-enum class MESIState {
+enum class MESIState : uint8_t {
     Invalid,
     Shared,
     Exclusive,
@@ -28,6 +29,27 @@ struct CacheLine {
     MESIState mesi_state{MESIState::Invalid};   // Coherence State
 };
 
+// 仅元数据的紧凑缓存行（METADATA_ONLY 模式）：不含数据块，
+// RRPV/valid/dirty/MESI 打包在 tag 之后的一个字节内，每行 16 字节。
+// 每组另有约 120 字节的固定开销（组对象、堆上的 shared_mutex 及分配器开销），
+// 16 路组合计约 23.5 字节/行，完整缓存行约 95 字节/行
+struct CompactCacheLine {
+    uint64_t tag;                               // Tag
+    uint8_t rrpv : 4;                           // Re-Reference Prediction Value (RRPV_M_BITS <= 4)
+    bool valid : 1;                             // Valid Bit
+    bool dirty : 1;                             // Dirty Bit
+    MESIState mesi_state : 2;                   // Coherence State
+
+    CompactCacheLine() noexcept
+        : tag(0), rrpv(2), valid(false), dirty(false), mesi_state(MESIState::Invalid) {}
+};
+
+static_assert(sizeof(CompactCacheLine) == 16, "CompactCacheLine must stay tag + one metadata byte");
+
+// 根据模板开关选择缓存行表示
+template <bool METADATA_ONLY>
+using CacheLineType = std::conditional_t<METADATA_ONLY, CompactCacheLine, CacheLine>;
+
 } // namespace SRRIP
 
 
@@ -9,12 +9,14 @@
 #define SRRIP_CACHE_H
 
 #include "cache_set.h"
+#include "../utils/set_replay_pool.h"
 
 #include <atomic>
+#include <memory>
 
 namespace SRRIP {
 
-template <uint8_t RRPV_M_BITS>
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY = false>
 class SRRIPCache {
 public:
     // 构造函数，定义缓存的几何结构
@@ -23,6 +25,12 @@ public:
     // 核心接口，访问一个内存地址，返回 true 表示命中， false 表示未命中
     bool access(uint64_t address);
 
+    // 并行回放地址序列：按组索引将地址划分给 num_threads 个工作线程，
+    // 每个组只由一个线程按原顺序访问，统计量先在线程本地累加，结束后合并。
+    // 统计结果与逐条调用 access() 完全一致。num_threads 为 0 时使用硬件并发数。
+    // 工作线程与分桶缓冲在多次调用间复用，适合按批次回放整条 trace
+    void replay(const uint64_t* addresses, size_t count, size_t num_threads = 0);
+
     // 获取统计信息
     [[nodiscard]] uint64_t getHitCount() const noexcept {
         return hit_count_.load(std::memory_order_relaxed);
@@ -40,17 +48,24 @@ public:
     void parseAddress(uint64_t address, uint64_t& tag, size_t& set_index) const;
 
 private:
+    using AccessOutcome = SetAccessOutcome;
+
+    // 在指定组内完成一次访问，不更新全局统计
+    AccessOutcome accessSet(size_t set_index, uint64_t tag);
 
     const size_t associativity_;
     const size_t num_sets_;
     const int offset_bits_;
     const int set_index_bits_;
 
-    std::vector<CacheSet<RRPV_M_BITS>> sets_;
+    std::vector<CacheSet<RRPV_M_BITS, METADATA_ONLY>> sets_;
 
     std::atomic<uint64_t> hit_count_{0};
     std::atomic<uint64_t> miss_count_{0};
     mutable std::atomic<size_t> replace_count_{0};
+
+    // replay() 的常驻工作线程，首次调用时创建，线程数不变时跨批次复用
+    std::unique_ptr<SetReplayPool> replay_pool_;
 };
 
 
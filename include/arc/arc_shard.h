@@ -0,0 +1,244 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 17:40:26
+@Description: ARC分片: 每个分片独立持有T1/T2/B1/B2、目标值p和锁
+@Language: C++17
+*/
+
+#ifndef ARC_SHARD_H
+#define ARC_SHARD_H
+
+#include "../lru/lru_shard.h"
+#include "../fifo/fifo_cache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+// 一个完整的ARC实例: 自己的T1/T2/B1/B2, 自己的目标值p, 自己的锁.
+// 分片之间不共享任何可变状态, 不同分片上的操作互不阻塞.
+// T1/T2的容量都给到分片容量c, 大小只由replace()按p控制;
+// B1/B2的容量沿用原先的约定: |B1| = c - p, |B2| = p.
+template <typename K, typename V, typename Hash = std::hash<std::string>>
+class ARCShard {
+public:
+    ARCShard(size_t p, size_t c);
+
+    ARCShard(const ARCShard&) = delete;
+    ARCShard& operator=(const ARCShard&) = delete;
+
+    bool get(const K& key, V& out_value);
+    void put(const K& key, const V& value, int expire_time = DEFAULT_EXPIRE_TIME);
+    bool remove(const K& key);
+    bool contains(const K& key) const;
+
+    size_t capacity() const { return c_; }
+    size_t targetP() const;
+    // 全局再平衡时设置p, 超过c时截断
+    void setTargetP(size_t p);
+
+    struct ShardStats {
+        size_t t1_size = 0;
+        size_t t2_size = 0;
+        size_t b1_size = 0;
+        size_t b2_size = 0;
+        size_t target_p = 0;
+    };
+    ShardStats getStats() const;
+
+private:
+    // 以下均要求调用者持有mtx_独占锁
+    void replace(bool in_b2);
+    void adaptP(bool hit_b1);
+    void resizeGhosts();
+    // 幽灵命中: 调整p, 必要时腾位置, 放入T2
+    void promoteGhost(const K& key, const V& value, bool hit_b1, int expire_time);
+
+private:
+    LRUShard<K, V, Hash> t1_;   // 最近访问一次的页面
+    LRUShard<K, V, Hash> t2_;   // 频繁访问的页面
+    FIFOCache<K, V, Hash> b1_;  // 从T1淘汰的页面
+    FIFOCache<K, V, Hash> b2_;  // 从T2淘汰的页面
+
+    size_t p_;  // T1的目标大小
+    size_t c_;  // T1 + T2 ≤ c
+    mutable std::shared_mutex mtx_;
+};
+
+template <typename K, typename V, typename Hash>
+ARCShard<K, V, Hash>::ARCShard(size_t p, size_t c)
+    : t1_(c), t2_(c),
+      b1_(static_cast<int>(std::max<size_t>(1, c - p))),
+      b2_(static_cast<int>(std::max<size_t>(1, p))),
+      p_(p), c_(c) {}
+
+template <typename K, typename V, typename Hash>
+void ARCShard<K, V, Hash>::resizeGhosts() {
+    b1_.resize(std::max<size_t>(1, c_ - p_));  // B1 = T2目标大小
+    b2_.resize(std::max<size_t>(1, p_));       // B2 = T1目标大小
+}
+
+template <typename K, typename V, typename Hash>
+void ARCShard<K, V, Hash>::adaptP(bool hit_b1) {
+    // 在命中的键移出幽灵表之前调用, 被命中的一侧至少为1
+    size_t b1_size = b1_.getSize();
+    size_t b2_size = b2_.getSize();
+
+    if (hit_b1) {
+        // 命中B1，增加T1的目标大小
+        size_t delta = std::max<size_t>(1, b2_size / std::max<size_t>(1, b1_size));
+        p_ = std::min(c_, p_ + delta);
+    } else {
+        // 命中B2，减少T1的目标大小
+        size_t delta = std::max<size_t>(1, b1_size / std::max<size_t>(1, b2_size));
+        p_ = (p_ > delta) ? p_ - delta : 0;
+    }
+    resizeGhosts();
+}
+
+template <typename K, typename V, typename Hash>
+void ARCShard<K, V, Hash>::replace(bool in_b2) {
+    size_t t1_size = t1_.size();
+
+    // 如果T1不为空且(|T1| > p 或 (key在B2中且|T1| = p))
+    if (t1_size > 0 && (t1_size > p_ || (in_b2 && t1_size == p_))) {
+        // 从T1中淘汰最久未使用的页面
+        auto evicted_node = t1_.evict();
+        if (evicted_node) {
+            b1_.put(evicted_node->key, evicted_node->value);
+            delete evicted_node;
+        }
+    } else if (t2_.size() > 0) {
+        // 从T2中淘汰最久未使用的页面
+        auto evicted_node = t2_.evict();
+        if (evicted_node) {
+            b2_.put(evicted_node->key, evicted_node->value);
+            delete evicted_node;
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void ARCShard<K, V, Hash>::promoteGhost(const K& key, const V& value, bool hit_b1, int expire_time) {
+    adaptP(hit_b1);
+    if (hit_b1) {
+        b1_.remove(key);
+    } else {
+        b2_.remove(key);
+    }
+
+    // 可能需要替换
+    if (t1_.size() + t2_.size() >= c_) {
+        replace(!hit_b1);
+    }
+    t2_.put(key, value, expire_time);
+}
+
+template <typename K, typename V, typename Hash>
+bool ARCShard<K, V, Hash>::get(const K& key, V& out_value) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+
+    // Case 1: 命中T1，移动到T2
+    if (t1_.get(key, out_value)) {
+        t1_.remove(key);
+        t2_.put(key, out_value);
+        return true;
+    }
+
+    // Case 2: 命中T2，更新LRU位置
+    if (t2_.get(key, out_value)) {
+        return true;
+    }
+
+    // Case 3/4: 命中B1/B2，调整参数并放入T2
+    V value;
+    if (b1_.get(key, value)) {
+        promoteGhost(key, value, true, DEFAULT_EXPIRE_TIME);
+        out_value = value;
+        return true;
+    }
+    if (b2_.get(key, value)) {
+        promoteGhost(key, value, false, DEFAULT_EXPIRE_TIME);
+        out_value = value;
+        return true;
+    }
+
+    return false;
+}
+
+template <typename K, typename V, typename Hash>
+void ARCShard<K, V, Hash>::put(const K& key, const V& value, int expire_time) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+
+    // Case 1: 已在T1中，移动到T2
+    if (t1_.contains(key)) {
+        t1_.remove(key);
+        t2_.put(key, value, expire_time);
+        return;
+    }
+
+    // Case 2: 已在T2中，更新值
+    if (t2_.contains(key)) {
+        t2_.put(key, value, expire_time);
+        return;
+    }
+
+    // Case 3/4: 在B1/B2中，调整参数并放入T2
+    if (b1_.contains(key)) {
+        promoteGhost(key, value, true, expire_time);
+        return;
+    }
+    if (b2_.contains(key)) {
+        promoteGhost(key, value, false, expire_time);
+        return;
+    }
+
+    // Case 5: 新键，放入T1
+    if (t1_.size() + t2_.size() >= c_) {
+        replace(false);
+    }
+    t1_.put(key, value, expire_time);
+}
+
+template <typename K, typename V, typename Hash>
+bool ARCShard<K, V, Hash>::remove(const K& key) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    bool removed = t1_.remove(key);
+    removed = t2_.remove(key) || removed;
+    return removed;
+}
+
+template <typename K, typename V, typename Hash>
+bool ARCShard<K, V, Hash>::contains(const K& key) const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return t1_.contains(key) || t2_.contains(key);
+}
+
+template <typename K, typename V, typename Hash>
+size_t ARCShard<K, V, Hash>::targetP() const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return p_;
+}
+
+template <typename K, typename V, typename Hash>
+void ARCShard<K, V, Hash>::setTargetP(size_t p) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    p_ = std::min(p, c_);
+    resizeGhosts();
+}
+
+template <typename K, typename V, typename Hash>
+typename ARCShard<K, V, Hash>::ShardStats ARCShard<K, V, Hash>::getStats() const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    ShardStats stats;
+    stats.t1_size = t1_.size();
+    stats.t2_size = t2_.size();
+    stats.b1_size = b1_.getSize();
+    stats.b2_size = b2_.getSize();
+    stats.target_p = p_;
+    return stats;
+}
+
+#endif // ARC_SHARD_H
@@ -0,0 +1,81 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-9 21:02:37
+@Description: 多级缓存层次模拟（L1/L2/LLC）
+@Language: C++17
+*/
+
+#ifndef HIERARCHY_CACHE_HIERARCHY_H
+#define HIERARCHY_CACHE_HIERARCHY_H
+
+#include "cache_level.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Hierarchy {
+
+enum class InclusionPolicy : uint8_t {
+    Inclusive,  // 下级包含上级全部行，下级替换时反向失效上级
+    Exclusive,  // 每行只存在于一级，未命中只填入 L1，上级牺牲者下沉到下一级
+    NINE,       // 非包含非独占：未命中填入所有级，替换互不影响
+};
+
+struct LevelStats {
+    uint64_t accesses = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;            // 被替换出的有效行
+    uint64_t writebacks = 0;           // 写回到下一级（或内存）的脏行
+    uint64_t back_invalidations = 0;   // 因下级替换被反向失效的行（仅包含式）
+
+    [[nodiscard]] double missRate() const noexcept {
+        return accesses == 0 ? 0.0 : static_cast<double>(misses) / accesses;
+    }
+};
+
+// 按顺序串联若干级缓存，levels[0] 为 L1，最后一级为 LLC，其后为内存
+class CacheHierarchy {
+public:
+    // 所有级的块大小必须一致
+    CacheHierarchy(std::vector<std::unique_ptr<CacheLevel>> levels, InclusionPolicy policy);
+
+    // 访问一个地址，返回命中的级别下标，numLevels() 表示从内存取得
+    size_t access(uint64_t address, bool is_write = false);
+
+    [[nodiscard]] size_t numLevels() const noexcept { return levels_.size(); }
+    [[nodiscard]] InclusionPolicy policy() const noexcept { return policy_; }
+    [[nodiscard]] const CacheLevel& level(size_t index) const { return *levels_.at(index); }
+
+    [[nodiscard]] LevelStats getLevelStats(size_t index) const;
+    [[nodiscard]] uint64_t getMemoryReads() const;
+    [[nodiscard]] uint64_t getMemoryWritebacks() const;
+
+    // 端到端未命中率：访问最终落到内存的比例
+    [[nodiscard]] double getGlobalMissRate() const;
+
+private:
+    // levels_[index] 填入地址，并处理由此产生的牺牲者
+    void fillLevel(size_t index, uint64_t address, bool dirty);
+
+    // 处理 levels_[index] 替换出的牺牲者
+    void handleVictim(size_t index, Victim victim);
+
+    // 把脏行写回到 levels_[index]（index == numLevels() 时写回内存）
+    void writeback(size_t index, uint64_t address);
+
+    std::vector<std::unique_ptr<CacheLevel>> levels_;
+    const InclusionPolicy policy_;
+
+    std::vector<LevelStats> stats_;
+    uint64_t total_accesses_{0};
+    uint64_t memory_reads_{0};
+    uint64_t memory_writebacks_{0};
+
+    mutable std::mutex mtx_;
+};
+
+} // namespace Hierarchy
+
+#endif // HIERARCHY_CACHE_HIERARCHY_H
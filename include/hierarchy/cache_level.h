@@ -0,0 +1,208 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-9 20:18:44
+@Description: 多级缓存层次中的单级缓存抽象
+@Language: C++17
+*/
+
+#ifndef HIERARCHY_CACHE_LEVEL_H
+#define HIERARCHY_CACHE_LEVEL_H
+
+#include "../SRRIP/cache_set.h"
+#include "../../src/BRRIP/cache_set.h"
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Hierarchy {
+
+// 被替换出的缓存行（块对齐地址）
+struct Victim {
+    uint64_t address;
+    bool dirty;
+};
+
+// 层次结构中的一级缓存，只负责标签/替换状态，不含数据
+class CacheLevel {
+public:
+    virtual ~CacheLevel() = default;
+
+    // 查找地址，命中时更新替换状态；is_write 为 true 时命中行标记为脏
+    virtual bool lookup(uint64_t address, bool is_write) = 0;
+
+    // 填充一个当前不在本级的地址，返回被替换出的有效行
+    virtual std::optional<Victim> fill(uint64_t address, bool dirty) = 0;
+
+    // 若地址在本级则标记为脏并返回 true（接收上级写回）
+    virtual bool markDirty(uint64_t address) = 0;
+
+    // 使地址失效，存在时返回该行是否为脏
+    virtual std::optional<bool> invalidate(uint64_t address) = 0;
+
+    [[nodiscard]] virtual const std::string& name() const noexcept = 0;
+    [[nodiscard]] virtual size_t blockSize() const noexcept = 0;
+};
+
+// 基于组相联 CacheSet 的一级缓存，Set 需提供 SRRIP::CacheSet 的接口：
+// findWay / findEmptyWay / findVictimWay / accessWay / fillWay / markDirty / invalidateWay / getLine
+template <typename Set>
+class SetAssociativeLevel : public CacheLevel {
+public:
+    SetAssociativeLevel(std::string name, size_t cache_size_kb, size_t block_size_bytes, size_t associativity)
+        : name_(std::move(name)), block_size_(block_size_bytes) {
+        if (cache_size_kb == 0 || block_size_bytes == 0 || associativity == 0) {
+            throw std::invalid_argument("Cache parameters must be positive");
+        }
+        if ((block_size_bytes & (block_size_bytes - 1)) != 0) {
+            throw std::invalid_argument("Block size must be a power of 2");
+        }
+        size_t total_bytes = cache_size_kb * 1024;
+        if (total_bytes % block_size_bytes != 0) {
+            throw std::invalid_argument("Cache size must be divisible by block size");
+        }
+        size_t total_blocks = total_bytes / block_size_bytes;
+        if (total_blocks % associativity != 0) {
+            throw std::invalid_argument("Total blocks must be divisible by associativity");
+        }
+        size_t num_sets = total_blocks / associativity;
+        if ((num_sets & (num_sets - 1)) != 0) {
+            throw std::invalid_argument("Number of sets must be a power of 2");
+        }
+
+        offset_bits_ = static_cast<int>(std::log2(block_size_bytes));
+        set_index_bits_ = static_cast<int>(std::log2(num_sets));
+
+        sets_.reserve(num_sets);
+        for (size_t i = 0; i < num_sets; ++i) {
+            sets_.emplace_back(associativity, i);
+        }
+    }
+
+    bool lookup(uint64_t address, bool is_write) override {
+        uint64_t tag;
+        size_t set_index;
+        parseAddress(address, tag, set_index);
+        auto& set = sets_[set_index];
+        auto way = set.findWay(tag);
+        if (!way.has_value()) {
+            return false;
+        }
+        set.accessWay(way.value());
+        if (is_write) {
+            set.markDirty(way.value());
+        }
+        return true;
+    }
+
+    std::optional<Victim> fill(uint64_t address, bool dirty) override {
+        uint64_t tag;
+        size_t set_index;
+        parseAddress(address, tag, set_index);
+        auto& set = sets_[set_index];
+
+        std::optional<Victim> victim;
+        size_t way;
+        if (auto empty_way = set.findEmptyWay()) {
+            way = empty_way.value();
+        } else {
+            way = set.findVictimWay();
+            const auto& line = set.getLine(way);
+            victim = Victim{composeAddress(line.tag, set_index), line.dirty};
+        }
+
+        set.fillWay(way, tag);
+        if (dirty) {
+            set.markDirty(way);
+        }
+        return victim;
+    }
+
+    bool markDirty(uint64_t address) override {
+        uint64_t tag;
+        size_t set_index;
+        parseAddress(address, tag, set_index);
+        auto& set = sets_[set_index];
+        auto way = set.findWay(tag);
+        if (!way.has_value()) {
+            return false;
+        }
+        set.markDirty(way.value());
+        return true;
+    }
+
+    std::optional<bool> invalidate(uint64_t address) override {
+        uint64_t tag;
+        size_t set_index;
+        parseAddress(address, tag, set_index);
+        auto& set = sets_[set_index];
+        auto way = set.findWay(tag);
+        if (!way.has_value()) {
+            return std::nullopt;
+        }
+        bool dirty = set.getLine(way.value()).dirty;
+        set.invalidateWay(way.value());
+        return dirty;
+    }
+
+    [[nodiscard]] const std::string& name() const noexcept override { return name_; }
+    [[nodiscard]] size_t blockSize() const noexcept override { return block_size_; }
+
+private:
+    void parseAddress(uint64_t address, uint64_t& tag, size_t& set_index) const {
+        set_index = (address >> offset_bits_) & ((1ULL << set_index_bits_) - 1);
+        tag = address >> (offset_bits_ + set_index_bits_);
+    }
+
+    uint64_t composeAddress(uint64_t tag, size_t set_index) const {
+        return (tag << (offset_bits_ + set_index_bits_)) | (static_cast<uint64_t>(set_index) << offset_bits_);
+    }
+
+    std::string name_;
+    size_t block_size_;
+    int offset_bits_{0};
+    int set_index_bits_{0};
+    std::vector<Set> sets_;
+};
+
+// 真 LRU 组，接口与 SRRIP::CacheSet 一致，用作层次中的 LRU 级。
+// 不加锁：由 CacheHierarchy 串行化访问
+class LRUSet {
+public:
+    struct Line {
+        uint64_t tag{0};
+        uint64_t last_use{0};
+        bool valid{false};
+        bool dirty{false};
+    };
+
+    explicit LRUSet(size_t associativity, uint64_t seed = 0);
+
+    [[nodiscard]] std::optional<size_t> findWay(uint64_t tag) const;
+    [[nodiscard]] std::optional<size_t> findEmptyWay() const;
+    [[nodiscard]] size_t findVictimWay();
+    void accessWay(size_t way_index);
+    void fillWay(size_t way_index, uint64_t tag);
+    void markDirty(size_t way_index);
+    void invalidateWay(size_t way_index);
+    [[nodiscard]] const Line& getLine(size_t way_index) const { return ways_[way_index]; }
+
+private:
+    std::vector<Line> ways_;
+    uint64_t clock_{0};
+};
+
+template <uint8_t RRPV_M_BITS = 2, bool METADATA_ONLY = false>
+using SRRIPLevel = SetAssociativeLevel<SRRIP::CacheSet<RRPV_M_BITS, METADATA_ONLY>>;
+
+template <uint8_t RRPV_M_BITS = 2, bool METADATA_ONLY = false>
+using BRRIPLevel = SetAssociativeLevel<BRRIP::CacheSet<RRPV_M_BITS, METADATA_ONLY>>;
+
+using LRULevel = SetAssociativeLevel<LRUSet>;
+
+} // namespace Hierarchy
+
+#endif // HIERARCHY_CACHE_LEVEL_H
@@ -278,7 +278,8 @@ Node<K, V>* LRUShard<K, V, Hash>::evict() {
     if (head->next == head) {
         return nullptr;
     }
-    Node<K, V>* node = head->next;
+    // 最久未使用的在尾部, pushToFront放在head->next
+    Node<K, V>* node = head->prev;
     remove(node);
     keyToNode.erase(node->key);
     ++evictions_;
@@ -0,0 +1,142 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 12:20:05
+@Description: 分片Sieve缓存: 2的幂分片, 每分片独立指针, 全局容量预算可在分片间借用
+@Language: C++17
+*/
+
+#ifndef SIEVE_SHARDED_CACHE_H
+#define SIEVE_SHARDED_CACHE_H
+
+#include "sieve_shard.h"
+#include "../utils/bit_utils.h"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace Sieve {
+
+// SIEVE split into power-of-two shards, each with its own queue, hand and
+// lock. The capacity is one global budget: every shard is guaranteed its
+// share, but a hot shard keeps inserting past it while colder shards leave
+// budget unused. Once the budget is exhausted a shard at or above its share
+// evicts from itself, and one below its share reclaims the loan by evicting
+// from the shard that borrowed the most.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class ShardedSieveCache {
+public:
+    // shard_count 0 picks 2x hardware threads; rounded to a power of two and
+    // capped so every shard's share is at least one entry
+    explicit ShardedSieveCache(size_t capacity, size_t shard_count = 0);
+    ~ShardedSieveCache() = default;
+
+    // Get value by key, returns std::nullopt if key not found
+    std::optional<V> get(const K& key);
+
+    // Insert or update key-value pair in cache
+    void put(const K& key, const V& value);
+
+    // Delete entry by key, returns true if deleted, false if key not found
+    bool del(const K& key);
+
+    bool contains(const K& key) const;
+    size_t size() const { return used_.load(std::memory_order_relaxed); }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size() == 0; }
+    size_t shard_count() const { return shard_count_; }
+    size_t shard_size(size_t shard) const { return shards_[shard]->size(); }
+
+private:
+    size_t getShard(const K& key) const;
+
+    // shard holding the most entries beyond its share, or the caller's
+    // own when nobody is over (a racing insert already took the room)
+    size_t pickDonor(size_t self) const;
+
+private:
+    std::atomic<size_t> used_{0};
+    size_t capacity_;
+    size_t shard_count_;
+    std::vector<std::unique_ptr<SieveShard<K, V, Hash>>> shards_;
+    Hash hasher_;
+};
+
+template <typename K, typename V, typename Hash>
+ShardedSieveCache<K, V, Hash>::ShardedSieveCache(size_t capacity, size_t shard_count) : capacity_(capacity) {
+    if (capacity_ == 0) {
+        throw std::invalid_argument("Capacity must be greater than 0");
+    }
+    if (shard_count == 0) {
+        shard_count = std::thread::hardware_concurrency() * 2;
+    }
+    // largest power of two not above capacity_
+    const size_t max_shards = nextPowerOf2(capacity_ + 1) / 2;
+    shard_count_ = std::min<size_t>(nextPowerOf2(shard_count), max_shards);
+
+    shards_.reserve(shard_count_);
+    for (size_t i = 0; i < shard_count_; ++i) {
+        // spread the remainder so the shares sum to capacity_
+        size_t share = capacity_ / shard_count_ + (i < capacity_ % shard_count_ ? 1 : 0);
+        shards_.emplace_back(std::make_unique<SieveShard<K, V, Hash>>(share, used_, capacity_));
+    }
+}
+
+template <typename K, typename V, typename Hash>
+size_t ShardedSieveCache<K, V, Hash>::getShard(const K& key) const {
+    // mix the high bits in, std::hash is the identity for integers
+    size_t hash_val = hasher_(key);
+    hash_val ^= hash_val >> 17;
+    return hash_val & (shard_count_ - 1);
+}
+
+template <typename K, typename V, typename Hash>
+size_t ShardedSieveCache<K, V, Hash>::pickDonor(size_t self) const {
+    size_t donor = self;
+    size_t most_borrowed = 0;
+    for (size_t i = 0; i < shard_count_; ++i) {
+        size_t size = shards_[i]->size();
+        size_t share = shards_[i]->share();
+        if (size > share && size - share > most_borrowed) {
+            most_borrowed = size - share;
+            donor = i;
+        }
+    }
+    return donor;
+}
+
+template <typename K, typename V, typename Hash>
+std::optional<V> ShardedSieveCache<K, V, Hash>::get(const K& key) {
+    return shards_[getShard(key)]->get(key);
+}
+
+template <typename K, typename V, typename Hash>
+void ShardedSieveCache<K, V, Hash>::put(const K& key, const V& value) {
+    const size_t self = getShard(key);
+    // Each failed attempt frees one entry elsewhere first. The shard lock is
+    // not held meanwhile, so two shards never wait on each other; another
+    // insert may grab the freed room, in which case we simply go again.
+    while (!shards_[self]->put(key, value)) {
+        size_t donor = pickDonor(self);
+        if (donor == self || !shards_[donor]->evictOne()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename K, typename V, typename Hash>
+bool ShardedSieveCache<K, V, Hash>::del(const K& key) {
+    return shards_[getShard(key)]->remove(key);
+}
+
+template <typename K, typename V, typename Hash>
+bool ShardedSieveCache<K, V, Hash>::contains(const K& key) const {
+    return shards_[getShard(key)]->contains(key);
+}
+
+} // namespace Sieve
+
+#endif // SIEVE_SHARDED_CACHE_H
@@ -0,0 +1,246 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 12:02:37
+@Description: Sieve缓存分片: 命中只读查找并置位visited, 插入/淘汰在分片内串行
+@Language: C++17
+*/
+
+#ifndef SIEVE_SHARD_H
+#define SIEVE_SHARD_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Sieve {
+
+// One SIEVE queue with its own hand. SIEVE never reorders the queue on a
+// hit, the hit only sets `visited`, so get() needs nothing but a map lookup
+// under the shared lock and a relaxed store to the entry's atomic flag:
+// readers never exclude each other. Insertion, deletion and the hand sweep
+// take the exclusive lock.
+//
+// In a sharded cache, capacity is accounted against a budget shared by all
+// shards: a shard may grow past its share while the budget has room, and
+// evicts from itself once the budget is used up and it holds at least its
+// share. A standalone shard is its own budget.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class SieveShard {
+public:
+    explicit SieveShard(size_t capacity);
+    // share: entries guaranteed to this shard; used/budget: the shared count
+    SieveShard(size_t share, std::atomic<size_t>& used, size_t budget);
+    ~SieveShard();
+
+    SieveShard(const SieveShard&) = delete;
+    SieveShard& operator=(const SieveShard&) = delete;
+
+    // Get value by key, returns std::nullopt if key not found
+    std::optional<V> get(const K& key);
+
+    // Insert or update key-value pair, evicting one entry when full.
+    // false when the budget is used up but this shard is below its share:
+    // the caller must free an entry in a shard that borrowed, then retry
+    bool put(const K& key, const V& value);
+
+    // Delete entry by key, returns true if deleted, false if key not found
+    bool remove(const K& key);
+
+    // evict one entry to give its budget back, false when empty
+    bool evictOne();
+
+    bool contains(const K& key) const;
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    size_t capacity() const { return share_; }
+    size_t share() const { return share_; }
+
+private:
+    struct Entry {
+        K key;
+        V value;
+        std::atomic<uint8_t> visited{0};
+        Entry* prev = nullptr;  // towards the head (newer)
+        Entry* next = nullptr;  // towards the tail (older)
+
+        Entry(const K& k, const V& v) : key(k), value(v) {}
+    };
+
+    // caller holds mtx_ exclusively
+    void pushHead(Entry* entry);
+    void unlink(Entry* entry);
+    void evict();
+
+private:
+    mutable std::shared_mutex mtx_;
+    std::unordered_map<K, Entry*, Hash> map_;
+    Entry* head_ = nullptr;  // newest insertion
+    Entry* tail_ = nullptr;  // oldest insertion
+    Entry* hand_ = nullptr;  // next eviction candidate, nullptr = start at tail
+
+    std::atomic<size_t> size_{0};  // readable without the lock, for donor choice
+    size_t share_;
+    std::atomic<size_t> own_used_{0};  // the budget count of a standalone shard
+    std::atomic<size_t>& used_;
+    size_t budget_;
+};
+
+template <typename K, typename V, typename Hash>
+SieveShard<K, V, Hash>::SieveShard(size_t capacity) : SieveShard(capacity, own_used_, capacity) {}
+
+template <typename K, typename V, typename Hash>
+SieveShard<K, V, Hash>::SieveShard(size_t share, std::atomic<size_t>& used, size_t budget)
+    : share_(share), used_(used), budget_(budget) {
+    if (share_ == 0) {
+        throw std::invalid_argument("Capacity must be greater than 0");
+    }
+    map_.reserve(share_);
+}
+
+template <typename K, typename V, typename Hash>
+SieveShard<K, V, Hash>::~SieveShard() {
+    for (auto& [key, entry] : map_) {
+        delete entry;
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void SieveShard<K, V, Hash>::pushHead(Entry* entry) {
+    entry->next = head_;
+    if (head_ != nullptr) {
+        head_->prev = entry;
+    } else {
+        tail_ = entry;
+    }
+    head_ = entry;
+}
+
+template <typename K, typename V, typename Hash>
+void SieveShard<K, V, Hash>::unlink(Entry* entry) {
+    if (hand_ == entry) {
+        hand_ = entry->prev;
+    }
+    if (entry->prev != nullptr) {
+        entry->prev->next = entry->next;
+    } else {
+        head_ = entry->next;
+    }
+    if (entry->next != nullptr) {
+        entry->next->prev = entry->prev;
+    } else {
+        tail_ = entry->prev;
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void SieveShard<K, V, Hash>::evict() {
+    // Sweep from the hand towards the head, clearing visited bits, and evict
+    // the first unvisited entry; past the head the hand wraps to the tail.
+    // We hold the lock exclusively, so no get() runs meanwhile: the flag is
+    // atomic only because concurrent readers set it under the shared lock.
+    Entry* victim = hand_ != nullptr ? hand_ : tail_;
+    while (victim != nullptr && victim->visited.load(std::memory_order_relaxed) != 0) {
+        victim->visited.store(0, std::memory_order_relaxed);
+        victim = victim->prev != nullptr ? victim->prev : tail_;
+    }
+    if (victim == nullptr) {
+        return;
+    }
+    hand_ = victim;
+    unlink(victim);
+    map_.erase(victim->key);
+    delete victim;
+    size_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename K, typename V, typename Hash>
+std::optional<V> SieveShard<K, V, Hash>::get(const K& key) {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+        return std::nullopt;
+    }
+
+    Entry* entry = it->second;
+    // skip the store when already set, keeping hot lines shared across cores
+    if (entry->visited.load(std::memory_order_relaxed) == 0) {
+        entry->visited.store(1, std::memory_order_relaxed);
+    }
+    return entry->value;
+}
+
+template <typename K, typename V, typename Hash>
+bool SieveShard<K, V, Hash>::put(const K& key, const V& value) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+
+    auto it = map_.find(key);
+    if (it != map_.end()) {
+        Entry* entry = it->second;
+        entry->value = value;
+        entry->visited.store(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (used_.fetch_add(1, std::memory_order_relaxed) >= budget_) {
+        // no room left anywhere: replace one of our own entries if we hold
+        // at least our share, otherwise someone else has to give one back.
+        // A replacement keeps the count, so drop the reservation only after
+        // the victim is gone and no other shard can slip into the gap.
+        if (map_.size() < share_) {
+            used_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        evict();
+        used_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    Entry* entry = new Entry(key, value);
+    pushHead(entry);
+    map_.emplace(key, entry);
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool SieveShard<K, V, Hash>::remove(const K& key) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+        return false;
+    }
+
+    Entry* entry = it->second;
+    unlink(entry);
+    map_.erase(it);
+    delete entry;
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    used_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool SieveShard<K, V, Hash>::evictOne() {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    if (map_.empty()) {
+        return false;
+    }
+    evict();
+    used_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool SieveShard<K, V, Hash>::contains(const K& key) const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return map_.find(key) != map_.end();
+}
+
+} // namespace Sieve
+
+#endif // SIEVE_SHARD_H
@@ -0,0 +1,111 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-5 21:12:40
+@Description: 二进制内存访问 trace 读取（mmap / 流式解压）
+@Language: C++17
+*/
+
+#ifndef TRACE_READER_H
+#define TRACE_READER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace Trace {
+
+// Trace 格式：连续的小端 uint64_t 地址，无文件头。
+// 压缩 trace 为同一格式整体经 gzip（.gz）或 zstd（.zst）压缩后的文件。
+
+class TraceReader {
+public:
+    virtual ~TraceReader() = default;
+
+    // 取下一批地址，返回批内地址数，0 表示读完；
+    // batch 指向的数据在下一次调用 nextBatch 前有效
+    virtual size_t nextBatch(const uint64_t*& batch) = 0;
+};
+
+// 未压缩 trace：整个文件 mmap 到内存，按批零拷贝返回
+class MappedTraceReader : public TraceReader {
+public:
+    explicit MappedTraceReader(const std::string& path, size_t batch_size = DEFAULT_BATCH_SIZE);
+    ~MappedTraceReader() override;
+
+    MappedTraceReader(const MappedTraceReader&) = delete;
+    MappedTraceReader& operator=(const MappedTraceReader&) = delete;
+
+    size_t nextBatch(const uint64_t*& batch) override;
+
+    // 文件中的地址总数
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+    [[nodiscard]] const uint64_t* data() const noexcept { return data_; }
+
+    static constexpr size_t DEFAULT_BATCH_SIZE = 1 << 20;
+
+private:
+    void* mapping_{nullptr};
+    size_t mapped_bytes_{0};
+    const uint64_t* data_{nullptr};
+    size_t count_{0};
+    size_t pos_{0};
+    const size_t batch_size_;
+};
+
+// 字节流解码器（gzip / zstd），由后台线程调用
+class StreamDecoder {
+public:
+    virtual ~StreamDecoder() = default;
+
+    // 读取最多 len 字节到 dst，返回实际字节数，0 表示结束；出错时抛出异常
+    virtual size_t read(void* dst, size_t len) = 0;
+};
+
+// 压缩 trace：后台线程解压到两个缓冲区之一，消费者处理另一个（双缓冲）
+class StreamingTraceReader : public TraceReader {
+public:
+    StreamingTraceReader(std::unique_ptr<StreamDecoder> decoder, size_t batch_size = DEFAULT_BATCH_SIZE);
+    ~StreamingTraceReader() override;
+
+    StreamingTraceReader(const StreamingTraceReader&) = delete;
+    StreamingTraceReader& operator=(const StreamingTraceReader&) = delete;
+
+    // 解码线程中的异常会在这里重新抛出
+    size_t nextBatch(const uint64_t*& batch) override;
+
+    static constexpr size_t DEFAULT_BATCH_SIZE = 1 << 20;
+
+private:
+    struct Buffer {
+        std::vector<uint64_t> addresses;
+        size_t count{0};
+        bool ready{false};      // 已解码、等待消费
+    };
+
+    void decodeLoop();
+
+    std::unique_ptr<StreamDecoder> decoder_;
+    Buffer buffers_[2];
+    size_t consume_index_{0};
+    bool has_current_{false};   // 消费者是否持有 buffers_[consume_index_]
+    bool stop_{false};
+    std::exception_ptr error_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::thread decode_thread_;
+};
+
+// 根据扩展名打开 trace：.gz / .zst 使用流式解压，其余使用 mmap。
+// 编译时未启用对应解压库时抛出 std::runtime_error
+std::unique_ptr<TraceReader> openTrace(const std::string& path);
+
+} // namespace Trace
+
+#endif // TRACE_READER_H
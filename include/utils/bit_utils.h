@@ -23,7 +23,18 @@ constexpr uint64_t nextPowerOf2(uint64_t value) {
     return value + 1;
 }
 
-
-
+// index of the lowest set bit, value must be non-zero (tzcnt/bsf on x86)
+inline unsigned countTrailingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+    unsigned n = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
 
 #endif
\ No newline at end of file
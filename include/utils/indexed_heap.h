@@ -0,0 +1,110 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 15:42:18
+@Description: 带位置索引的d叉最小堆, 节点记录自身下标, 支持原地升/降键与任意删除
+@Language: C++17
+*/
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include <cstddef>
+#include <vector>
+
+// Min-heap of NodeT* keyed by a double. Every node stores its own slot in
+// `heap_index`, so a node can be re-keyed or removed in O(log n) without a
+// search. Entries carry the key next to the pointer: with Arity = 4 the
+// children of a slot are 64 contiguous bytes, one cache line, and a sift
+// never dereferences the nodes it compares.
+template <typename NodeT, size_t Arity = 4>
+class IndexedHeap {
+public:
+    struct Entry {
+        double priority;
+        NodeT* node;
+    };
+
+    bool empty() const { return heap_.empty(); }
+    size_t size() const { return heap_.size(); }
+    const Entry& top() const { return heap_.front(); }
+    void clear() { heap_.clear(); }
+
+    void push(NodeT* node, double priority) {
+        node->heap_index = heap_.size();
+        heap_.push_back(Entry{priority, node});
+        siftUp(node->heap_index);
+    }
+
+    void remove(size_t index) {
+        Entry last = heap_.back();
+        heap_.pop_back();
+        if (index == heap_.size()) {
+            return;
+        }
+        heap_[index] = last;
+        last.node->heap_index = index;
+        restore(index);
+    }
+
+    // re-key in place, the new key may be larger or smaller
+    void update(size_t index, double priority) {
+        heap_[index].priority = priority;
+        restore(index);
+    }
+
+private:
+    void restore(size_t index) {
+        if (index > 0 && heap_[index].priority < heap_[(index - 1) / Arity].priority) {
+            siftUp(index);
+        } else {
+            siftDown(index);
+        }
+    }
+
+    void siftUp(size_t index) {
+        Entry entry = heap_[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / Arity;
+            if (!(entry.priority < heap_[parent].priority)) {
+                break;
+            }
+            place(index, heap_[parent]);
+            index = parent;
+        }
+        place(index, entry);
+    }
+
+    void siftDown(size_t index) {
+        Entry entry = heap_[index];
+        const size_t n = heap_.size();
+        while (true) {
+            size_t first = index * Arity + 1;
+            if (first >= n) {
+                break;
+            }
+            size_t last = first + Arity < n ? first + Arity : n;
+            size_t smallest = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (heap_[child].priority < heap_[smallest].priority) {
+                    smallest = child;
+                }
+            }
+            if (!(heap_[smallest].priority < entry.priority)) {
+                break;
+            }
+            place(index, heap_[smallest]);
+            index = smallest;
+        }
+        place(index, entry);
+    }
+
+    void place(size_t index, const Entry& entry) {
+        heap_[index] = entry;
+        entry.node->heap_index = index;
+    }
+
+private:
+    std::vector<Entry> heap_;
+};
+
+#endif // INDEXED_HEAP_H
@@ -0,0 +1,197 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 20:52:30
+@Description: SRRIP/BRRIP/DRRIP 共用的RRIP缓存集: 插入RRPV由调用方传给 fillWay
+@Language: C++17
+*/
+
+#ifndef RRIP_CACHE_SET_H
+#define RRIP_CACHE_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+// Line 为各策略自己的缓存行（CacheLine / CompactCacheLine），需有
+// valid / tag / rrpv / dirty / mesi_state 字段。
+// AGE_UP 为 true 时找牺牲者前整体老化，直到有行达到 RRPV_MAX（BRRIP/DRRIP）；
+// 为 false 时直接在最大 RRPV 的行中选择（SRRIP）。两种方式选出的行相同，
+// 只是老化会改写留下各行的 RRPV。
+template <typename Line, uint8_t RRPV_M_BITS, bool AGE_UP>
+class RRIPCacheSet {
+public:
+    static constexpr uint8_t RRPV_MAX = (1 << RRPV_M_BITS) - 1;
+
+    // ctor，传入该组的相联度（路的数量）和组内随机数种子
+    explicit RRIPCacheSet(size_t associativity, uint64_t seed = 0) {
+        if (associativity == 0) {
+            throw std::invalid_argument("associativity must be positive");
+        }
+        ways_.resize(associativity);
+        // xorshift state must be non-zero
+        rng_state_ = (seed + 1) * 0x9E3779B97F4A7C15ULL;
+        mtx_ = std::make_unique<std::shared_mutex>();
+    }
+
+    RRIPCacheSet(RRIPCacheSet&& other) noexcept = default;
+    RRIPCacheSet& operator=(RRIPCacheSet&& other) noexcept = default;
+
+    RRIPCacheSet(const RRIPCacheSet&) = delete;
+    RRIPCacheSet& operator=(const RRIPCacheSet&) = delete;
+
+    ~RRIPCacheSet() = default;
+
+    // 查找与给定 tag 匹配的 way 索引
+    [[nodiscard]] std::optional<size_t> findWay(uint64_t tag) const {
+        // read lock
+        std::shared_lock<std::shared_mutex> readLock(*mtx_);
+        for (size_t i = 0; i < ways_.size(); i++) {
+            if (ways_[i].valid && ways_[i].tag == tag) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // 查找一个空闲的 way 索引
+    [[nodiscard]] std::optional<size_t> findEmptyWay() const {
+        // read lock
+        std::shared_lock<std::shared_mutex> readLock(*mtx_);
+        for (size_t i = 0; i < ways_.size(); i++) {
+            if (!ways_[i].valid) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // 从最大 RRPV 的行中按 way 顺序随机选择牺牲者
+    [[nodiscard]] size_t findVictimWay() {
+        // write lock
+        std::unique_lock<std::shared_mutex> writeLock(*mtx_);
+        // one pass for the max RRPV and how many lines hold it
+        uint8_t max_rrpv = 0;
+        size_t candidates = 0;
+        for (const auto& line : ways_) {
+            if (!line.valid) {
+                continue;
+            }
+            if (line.rrpv > max_rrpv) {
+                max_rrpv = line.rrpv;
+                candidates = 1;
+            } else if (line.rrpv == max_rrpv) {
+                ++candidates;
+            }
+        }
+
+        if constexpr (AGE_UP) {
+            // RRPV Age-Up：所有行整体加上 RRPV_MAX - max_rrpv，相对顺序不变
+            const uint8_t delta = RRPV_MAX - max_rrpv;
+            if (delta != 0) {
+                for (auto& line : ways_) {
+                    if (line.valid) {
+                        line.rrpv = static_cast<uint8_t>(line.rrpv + delta);
+                    }
+                }
+            }
+            max_rrpv = RRPV_MAX;
+        }
+
+        size_t pick = nextRandom() % candidates;
+        for (size_t i = 0; i < ways_.size(); ++i) {
+            if (ways_[i].valid && ways_[i].rrpv == max_rrpv && pick-- == 0) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    // 访问一个 way（命中时调用），将其RRPV置为0
+    void accessWay(size_t way_index) {
+        // write lock
+        std::unique_lock<std::shared_mutex> writeLock(*mtx_);
+        auto& line = ways_[way_index];
+        line.rrpv = 0;
+        line.valid = true;
+    }
+
+    // 填充一个 way（未命中时调用），以 insert_rrpv 插入
+    void fillWay(size_t way_index, uint64_t tag, uint8_t insert_rrpv) {
+        // write lock
+        std::unique_lock<std::shared_mutex> writeLock(*mtx_);
+        fillLocked(way_index, tag, insert_rrpv);
+    }
+
+    // 双模插入：以 epsilon = 1/32 的概率插入 rare_rrpv，其余插入 insert_rrpv。
+    // 随机数取自组内状态，与牺牲者选择共用同一序列
+    void fillWayBimodal(size_t way_index, uint64_t tag, uint8_t insert_rrpv, uint8_t rare_rrpv) {
+        // write lock
+        std::unique_lock<std::shared_mutex> writeLock(*mtx_);
+        fillLocked(way_index, tag, (nextRandom() & 31) == 0 ? rare_rrpv : insert_rrpv);
+    }
+
+    // 标记一个 way 为脏（写命中或脏数据写回时调用）
+    void markDirty(size_t way_index) {
+        // write lock
+        std::unique_lock<std::shared_mutex> writeLock(*mtx_);
+        auto& line = ways_[way_index];
+        line.dirty = true;
+        line.mesi_state = MESIState::Modified;
+    }
+
+    // 使一个 way 失效（包含式层次的反向失效、独占式层次的上移）
+    void invalidateWay(size_t way_index) {
+        // write lock
+        std::unique_lock<std::shared_mutex> writeLock(*mtx_);
+        auto& line = ways_[way_index];
+        if (!line.valid) {
+            return;
+        }
+        line.valid = false;
+        line.dirty = false;
+        line.mesi_state = MESIState::Invalid;
+    }
+
+    // 读取一个 way 的缓存行（用于获取牺牲者的 tag / dirty）
+    [[nodiscard]] const Line& getLine(size_t way_index) const {
+        // read lock
+        std::shared_lock<std::shared_mutex> readLock(*mtx_);
+        return ways_[way_index];
+    }
+
+private:
+    using MESIState = decltype(Line::mesi_state);
+
+    // caller holds mtx_ exclusively
+    void fillLocked(size_t way_index, uint64_t tag, uint8_t insert_rrpv) {
+        auto& line = ways_[way_index];
+        line.valid = true;
+        line.tag = tag;
+        line.dirty = false;
+        line.mesi_state = MESIState::Exclusive;
+        line.rrpv = insert_rrpv;
+    }
+
+    uint64_t nextRandom() noexcept {
+        // xorshift64
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 7;
+        rng_state_ ^= rng_state_ << 17;
+        return rng_state_;
+    }
+
+    // RRPV 只存在各行中，老化和找牺牲者时扫描一遍 ways
+    std::vector<Line> ways_;
+    // per-set xorshift state: victim and insertion choices depend only on
+    // this set's history, so replaying a set on any thread yields the same result
+    uint64_t rng_state_;
+
+    mutable std::unique_ptr<std::shared_mutex> mtx_;
+};
+
+#endif // RRIP_CACHE_SET_H
@@ -0,0 +1,192 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 18:20:41
+@Description: 按组并行回放的常驻线程池: 一次扫描把地址分桶到所属线程, 每个线程只回放自己的桶
+@Language: C++17
+*/
+
+#ifndef SET_REPLAY_POOL_H
+#define SET_REPLAY_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 组相联缓存单次访问的结果
+enum class SetAccessOutcome : uint8_t {
+    Hit,
+    Fill,       // 未命中，填入空闲 way
+    Replace,    // 未命中，替换牺牲者
+};
+
+struct ReplayCounts {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t replacements = 0;
+};
+
+// Set-partitioned replay for set-associative caches. Worker `id` owns a
+// contiguous range of sets, so no two threads ever touch the same set and
+// each set sees its accesses in trace order.
+//
+// A replay reads the trace once. Phase 1: every worker takes a contiguous
+// slice of the trace and scatters its addresses into one bucket per owner.
+// Phase 2: every worker replays the buckets it owns, slice by slice in
+// trace order. The workers and the buckets outlive a call, so replaying a
+// trace batch by batch neither respawns threads nor reallocates buckets.
+// The calling thread acts as worker 0; one thread means no pool at all.
+class SetReplayPool {
+public:
+    // requested 为 0 时使用硬件并发数，且不超过组数
+    static size_t resolveThreads(size_t requested, size_t num_sets) {
+        if (requested == 0) {
+            requested = std::thread::hardware_concurrency();
+        }
+        return std::max<size_t>(1, std::min(requested, num_sets));
+    }
+
+    explicit SetReplayPool(size_t num_threads) : num_threads_(std::max<size_t>(1, num_threads)) {
+        buckets_.resize(num_threads_ * num_threads_);
+        workers_.reserve(num_threads_ - 1);
+        for (size_t id = 1; id < num_threads_; ++id) {
+            workers_.emplace_back(&SetReplayPool::workerLoop, this, id);
+        }
+    }
+
+    ~SetReplayPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    SetReplayPool(const SetReplayPool&) = delete;
+    SetReplayPool& operator=(const SetReplayPool&) = delete;
+
+    size_t threads() const { return num_threads_; }
+
+    // parse(address, tag, set_index) 解析地址; access(set_index, tag) 完成
+    // 一次组内访问并返回 SetAccessOutcome。set_index_bits 为组索引位数
+    template <typename ParseFn, typename AccessFn>
+    ReplayCounts replay(const uint64_t* addresses, size_t count, int set_index_bits,
+                        ParseFn parse, AccessFn access) {
+        const size_t n = num_threads_;
+        auto owner = [&](size_t set_index) { return (set_index * n) >> set_index_bits; };
+        auto replayOne = [&](uint64_t address, ReplayCounts& local) {
+            uint64_t tag;
+            size_t set_index;
+            parse(address, tag, set_index);
+            switch (access(set_index, tag)) {
+            case SetAccessOutcome::Hit:     ++local.hits; break;
+            case SetAccessOutcome::Replace: ++local.replacements; [[fallthrough]];
+            case SetAccessOutcome::Fill:    ++local.misses; break;
+            }
+        };
+
+        ReplayCounts total;
+        if (n == 1) {
+            for (size_t i = 0; i < count; ++i) {
+                replayOne(addresses[i], total);
+            }
+            return total;
+        }
+
+        // phase 1: scatter slice `id` into buckets_[id * n + owner]
+        runOnAll([&](size_t id) {
+            std::vector<uint64_t>* row = &buckets_[id * n];
+            for (size_t b = 0; b < n; ++b) {
+                row[b].clear();
+            }
+            const size_t begin = count * id / n;
+            const size_t end = count * (id + 1) / n;
+            for (size_t i = begin; i < end; ++i) {
+                uint64_t tag;
+                size_t set_index;
+                parse(addresses[i], tag, set_index);
+                row[owner(set_index)].push_back(addresses[i]);
+            }
+        });
+
+        // phase 2: replay buckets_[slice * n + id], slices in trace order
+        std::vector<ReplayCounts> results(n);
+        runOnAll([&](size_t id) {
+            ReplayCounts local;
+            for (size_t slice = 0; slice < n; ++slice) {
+                for (uint64_t address : buckets_[slice * n + id]) {
+                    replayOne(address, local);
+                }
+            }
+            results[id] = local;
+        });
+
+        // merge
+        for (const auto& local : results) {
+            total.hits += local.hits;
+            total.misses += local.misses;
+            total.replacements += local.replacements;
+        }
+        return total;
+    }
+
+private:
+    // 在所有线程上运行 job(id)，调用线程为 0 号，全部完成后返回
+    void runOnAll(const std::function<void(size_t)>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            job_ = &job;
+            pending_ = num_threads_ - 1;
+            ++generation_;
+        }
+        start_cv_.notify_all();
+        job(0);
+        std::unique_lock<std::mutex> lock(mtx_);
+        done_cv_.wait(lock, [this] { return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+    void workerLoop(size_t id) {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(size_t)>* job;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                start_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                job = job_;
+            }
+            (*job)(id);
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                --pending_;
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+private:
+    size_t num_threads_;
+    std::vector<std::thread> workers_;
+    std::vector<std::vector<uint64_t>> buckets_;
+
+    std::mutex mtx_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(size_t)>* job_ = nullptr;
+    uint64_t generation_ = 0;
+    size_t pending_ = 0;
+    bool stop_ = false;
+};
+
+#endif // SET_REPLAY_POOL_H
@@ -5,12 +5,15 @@
 @Language: C++17
 */
 
-#ifndef CACHE_LINE_H
-#define CACHE_LINE_H
+#ifndef BRRIP_CACHE_LINE_H
+#define BRRIP_CACHE_LINE_H
+
+#include <cstdint>
+#include <type_traits>
 
 namespace BRRIP {
     
-enum class MESIState {
+enum class MESIState : uint8_t {
     Invalid,
     Shared,
     Exclusive,
@@ -26,7 +29,26 @@ struct CacheLine {
     MESIState mesi_state{MESIState::Invalid};   // Coherence State
 };
 
+// 仅元数据的紧凑缓存行（METADATA_ONLY 模式）：不含数据块，
+// RRPV/valid/dirty/MESI 打包在 tag 之后的一个字节内，每行 16 字节
+struct CompactCacheLine {
+    uint64_t tag;                               // Tag
+    uint8_t rrpv : 4;                           // Re-Reference Prediction Value (RRPV_M_BITS <= 4)
+    bool valid : 1;                             // Valid Bit
+    bool dirty : 1;                             // Dirty Bit
+    MESIState mesi_state : 2;                   // Coherence State
+
+    CompactCacheLine() noexcept
+        : tag(0), rrpv(2), valid(false), dirty(false), mesi_state(MESIState::Invalid) {}
+};
+
+static_assert(sizeof(CompactCacheLine) == 16, "CompactCacheLine must stay tag + one metadata byte");
+
+// 根据模板开关选择缓存行表示
+template <bool METADATA_ONLY>
+using CacheLineType = std::conditional_t<METADATA_ONLY, CompactCacheLine, CacheLine>;
+
 
 } // namespace BRRIP
 
-#endif // CACHE_LINE_H
\ No newline at end of file
+#endif // BRRIP_CACHE_LINE_H
\ No newline at end of file
@@ -1,76 +1,39 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-28 20:12:01
+@LastEditTime: 2026-10-16 20:58:40
 @Description: BRRIP缓存集实现
 @Language: C++17
 */
 
-#ifndef CACHE_SET_H
-#define CACHE_SET_H
+#ifndef BRRIP_CACHE_SET_H
+#define BRRIP_CACHE_SET_H
 
 #include "cache_line.h"
+#include "../../include/utils/rrip_cache_set.h"
 
 #include <cstdint>
-#include <optional>
-#include <mutex>
-#include <memory>
-#include <shared_mutex>
-#include <vector>
 
 namespace BRRIP {
 
-template <uint8_t RRPV_M_BITS>
-class CacheSet {
-public:
-    // ctor，传入该组的相联度（路的数量）
-    explicit CacheSet(size_t associativity);
-
-    // move ctor
-    CacheSet(CacheSet&& other) noexcept;
-
-    CacheSet& operator=(CacheSet&& other) noexcept;
-
-    CacheSet(const CacheSet&) = delete;
-    CacheSet& operator=(const CacheSet&) = delete;
-
-    ~CacheSet() = default;
-
-    // 查找与给定tag匹配的way索引
-    [[nodiscard]] std::optional<size_t> findWay(uint64_t tag) const;
-
-    // 查找一个空闲的way索引
-    [[nodiscard]] std::optional<size_t> findEmptyWay() const;
-
-    // 根据BRRIP策略查找一个牺牲者way索引
-    [[nodiscard]] size_t findVictimWay();
+// METADATA_ONLY 为 true 时使用不含数据块的 CompactCacheLine。
+// 找牺牲者前整体老化，直到有行达到 RRPV_MAX
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY = false>
+class CacheSet : public RRIPCacheSet<CacheLineType<METADATA_ONLY>, RRPV_M_BITS, true> {
+    using Base = RRIPCacheSet<CacheLineType<METADATA_ONLY>, RRPV_M_BITS, true>;
+    static_assert(!METADATA_ONLY || RRPV_M_BITS <= 4, "CompactCacheLine stores RRPV in 4 bits");
 
-    // 访问一个way（命中时调用），将其RRPV设置为0
-    void accessWay(size_t way_index);
-
-    // 填充一个way（未命中时调用），设置tag和RRPV
-    void fillWay(size_t way_index, uint64_t tag);
-
-private:
-    static constexpr uint8_t RRPV_MAX = (1 << RRPV_M_BITS) - 1;
-    std::vector<CacheLine> ways_;
-    // buckets[r] stores the index of the cache line "RRPV = r"
-    std::vector<std::vector<size_t>> buckets_;
-    // State Bit: if rth bit is 1, there is a cache line "RRPV = r"
-    uint32_t rrpv_presence;
-    // max RRPV currently
-    uint8_t max_rrpv;
-    mutable std::unique_ptr<std::shared_mutex> mtx_;
-
-    struct Stats {
-        size_t hits = 0;
-        size_t misses = 0;
-        size_t replacements = 0;
-    } stats_;
+public:
+    // ctor，传入该组的相联度（路的数量）和组内随机数种子
+    using Base::Base;
+
+    // BRRIP策略：双模随机选择
+    // 以epsilon（通常是1/32 = 3.125%）的概率插入RRPV_MAX（远期预测）
+    // 以1-epsilon的概率插入RRPV_MAX-1（近期预测）
+    void fillWay(size_t way_index, uint64_t tag) {
+        Base::fillWayBimodal(way_index, tag, Base::RRPV_MAX - 1, Base::RRPV_MAX);
+    }
 };
 
-
-
-
 } // namespace BRRIP
 
-#endif // !CACHE_SET_H
+#endif // !BRRIP_CACHE_SET_H
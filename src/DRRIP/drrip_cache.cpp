@@ -0,0 +1,155 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-2 22:05:47
+@Description: DRRIP主缓存实现
+@Language: C++17
+*/
+
+#include "../../include/DRRIP/drrip_cache.h"
+
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+namespace DRRIP {
+
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+DRRIPCache<RRPV_M_BITS, METADATA_ONLY>::DRRIPCache(size_t cache_size_kb, size_t block_size_bytes, size_t associativity,
+                                    size_t leader_sets)
+    : associativity_(associativity), num_sets_(0), offset_bits_(0), set_index_bits_(0), leader_stride_(0) {
+    if (cache_size_kb == 0 || block_size_bytes == 0 || associativity == 0 || leader_sets == 0) {
+        throw std::invalid_argument("Cache parameters must be positive");
+    }
+
+    // block_size must be power of 2
+    if ((block_size_bytes & (block_size_bytes - 1)) != 0) {
+        throw std::invalid_argument("Block size must be a power of 2");
+    }
+
+    // calculate total block numbers
+    size_t total_bytes = cache_size_kb * 1024;
+    size_t total_blocks = total_bytes / block_size_bytes;
+    if (total_bytes % block_size_bytes != 0) {
+        throw std::invalid_argument("Cache size must be divisible by block size");
+    }
+
+    // total blocks must be divisible by associativity
+    if (total_blocks % associativity != 0) {
+        throw std::invalid_argument("Total blocks must be divisible by associativity");
+    }
+
+    // number of sets must be a power of 2
+    const_cast<size_t&>(num_sets_) = total_blocks / associativity;
+    if ((num_sets_ & (num_sets_ - 1)) != 0) {
+        throw std::invalid_argument("Number of sets must be a power of 2");
+    }
+
+    // calculate offset and index
+    const_cast<int&>(offset_bits_) = static_cast<int>(std::log2(block_size_bytes));
+    const_cast<int&>(set_index_bits_) = static_cast<int>(std::log2(num_sets_));
+
+    // 每个 stride 内第 0 组为 SRRIP leader，第 1 组为 BRRIP leader，其余为 follower；
+    // stride 小于 3 时没有 follower 组，PSEL 无从生效
+    if (num_sets_ / leader_sets < 3) {
+        throw std::invalid_argument("Too many leader sets: every set would be a leader");
+    }
+    leader_stride_ = num_sets_ / leader_sets;
+
+    // initialize all the sets
+    sets_.reserve(num_sets_);
+    for (size_t i = 0; i < num_sets_; ++i) {
+        sets_.emplace_back(associativity, i);
+    }
+}
+
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+void DRRIPCache<RRPV_M_BITS, METADATA_ONLY>::parseAddress(uint64_t address, uint64_t& tag, size_t& set_index) const {
+    set_index = (address >> offset_bits_) & ((1ULL << set_index_bits_) - 1);
+    tag = address >> (offset_bits_ + set_index_bits_);
+}
+
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+typename DRRIPCache<RRPV_M_BITS, METADATA_ONLY>::SetRole DRRIPCache<RRPV_M_BITS, METADATA_ONLY>::roleOf(size_t set_index) const noexcept {
+    switch (set_index % leader_stride_) {
+    case 0:  return SetRole::SRRIPLeader;
+    case 1:  return SetRole::BRRIPLeader;
+    default: return SetRole::Follower;
+    }
+}
+
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+void DRRIPCache<RRPV_M_BITS, METADATA_ONLY>::updatePsel(SetRole role) noexcept {
+    uint32_t cur = psel_.load(std::memory_order_relaxed);
+    uint32_t next;
+    do {
+        if (role == SetRole::SRRIPLeader) {
+            if (cur == PSEL_MAX) return;
+            next = cur + 1;
+        } else {
+            if (cur == 0) return;
+            next = cur - 1;
+        }
+    } while (!psel_.compare_exchange_weak(cur, next, std::memory_order_relaxed));
+}
+
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+bool DRRIPCache<RRPV_M_BITS, METADATA_ONLY>::access(uint64_t address) {
+    uint64_t tag;
+    size_t set_index;
+    parseAddress(address, tag, set_index);
+
+    assert(set_index < num_sets_ && "Invalid set index");
+
+    auto& target_set = sets_[set_index];
+    auto way = target_set.findWay(tag);
+
+    if (way.has_value()) {
+        target_set.accessWay(way.value());
+        hit_count_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    miss_count_.fetch_add(1, std::memory_order_relaxed);
+
+    const SetRole role = roleOf(set_index);
+    InsertionPolicy policy;
+    switch (role) {
+    case SetRole::SRRIPLeader:
+        policy = InsertionPolicy::SRRIP;
+        updatePsel(role);
+        break;
+    case SetRole::BRRIPLeader:
+        policy = InsertionPolicy::BRRIP;
+        updatePsel(role);
+        break;
+    default:
+        policy = getFollowerPolicy();
+        break;
+    }
+
+    // 1. find empty block
+    auto empty_way = target_set.findEmptyWay();
+    if (empty_way.has_value()) {
+        target_set.fillWay(empty_way.value(), tag, policy);
+        return false;
+    }
+
+    // 2. find victim and replace it
+    size_t victim_way = target_set.findVictimWay();
+    replace_count_.fetch_add(1, std::memory_order_relaxed);
+    target_set.fillWay(victim_way, tag, policy);
+    return false;
+}
+
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+uint64_t DRRIPCache<RRPV_M_BITS, METADATA_ONLY>::getHitRate() const noexcept {
+    uint64_t hits = hit_count_.load(std::memory_order_relaxed);
+    uint64_t misses = miss_count_.load(std::memory_order_relaxed);
+    uint64_t total = hits + misses;
+    if (total == 0) return 0;
+
+    return (hits * 100) / total;
+}
+
+} // namespace DRRIP
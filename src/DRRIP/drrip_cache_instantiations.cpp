@@ -0,0 +1,17 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-2 22:10:15
+@Description: DRRIP缓存模板实例化
+@Language: C++17
+*/
+
+#include "../../include/DRRIP/drrip_cache.h"
+#include "drrip_cache.cpp"
+
+// 显式实例化常用配置
+template class DRRIP::DRRIPCache<2>;  // 4个RRPV值 (0,1,2,3)
+template class DRRIP::DRRIPCache<3>;  // 8个RRPV值 (0,1,2,3,4,5,6,7)
+
+// 仅元数据模式（CompactCacheLine）
+template class DRRIP::DRRIPCache<2, true>;
+template class DRRIP::DRRIPCache<3, true>;
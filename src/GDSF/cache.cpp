@@ -1,6 +1,6 @@
 /*
 @Author: Lzww  
-@LastEditTime: 2025-8-23 21:22:25
+@LastEditTime: 2026-10-16 15:10:42
 @Description: GDSF Cache
 @Language: C++17
 */
@@ -22,27 +22,39 @@ bool GDSFCache<K, V, Hash>::put(const K& key, const V& value, size_t size) {
     if (size > capacity_) {
         return false;
     }
-    
-    size_t existing_frequency = 1;
+
     auto existing_it = lookup_table_.find(key);
     if (existing_it != lookup_table_.end()) {
-        existing_frequency = existing_it->second->frequency;
-        erase(key);
+        Node& node = existing_it->second;
+        node.value = value;
+        if (current_size_ - node.size + size <= capacity_) {
+            // fits without eviction: change the key in place, up or down
+            current_size_ = current_size_ - node.size + size;
+            node.size = size;
+            node.priority = calculate_priority(node.frequency, size);
+            heap_.update(node.heap_index, node.priority);
+            return true;
+        }
+        // grown past the free space: take it out while making room
+        current_size_ -= node.size;
+        heap_.remove(node.heap_index);
+        evict(size);
+        node.size = size;
+        node.priority = calculate_priority(node.frequency, size);
+        heap_.push(&node, node.priority);
+        current_size_ += size;
+        return true;
     }
 
     evict(size);
 
-    auto node = Node(key, value, size, calculate_priority(existing_frequency, size));
-    node.frequency = existing_frequency;
-
-    auto [it, success] = priority_queue_.insert(node);
-    if (success) {
-        lookup_table_.emplace(key, it);
-        current_size_ += size;
-        return true;
-    } else {
+    auto [it, success] = lookup_table_.try_emplace(key, key, value, size, calculate_priority(1, size));
+    if (!success) {
         return false;
     }
+    heap_.push(&it->second, it->second.priority);
+    current_size_ += size;
+    return true;
 }
 
 template <typename K, typename V, typename Hash>
@@ -54,25 +66,13 @@ std::optional<V> GDSFCache<K, V, Hash>::get(const K& key) {
         return std::nullopt;
     }
 
-    auto node_it = it->second;
-    const auto& node = *node_it;
-    V value = node.value;
-
-    // update frequency
-    priority_queue_.erase(node_it);
-    
-    // create updated node, increase frequency and recalculate priority
-    auto updated_node = node;
-    updated_node.frequency++;
-    updated_node.priority = calculate_priority(updated_node.frequency, updated_node.size);
-    
-    // reinsert
-    auto [new_it, success] = priority_queue_.insert(updated_node);
-    if (success) {
-        lookup_table_[key] = new_it;
-    }
+    // update frequency; L never decreases, so the priority only goes up and
+    // the heap entry can keep its old key until evict() meets it at the top
+    Node& node = it->second;
+    node.frequency++;
+    node.priority = calculate_priority(node.frequency, node.size);
 
-    return value;
+    return node.value;
 }
 
 template <typename K, typename V, typename Hash>
@@ -95,7 +95,7 @@ size_t GDSFCache<K, V, Hash>::capacity() const {
 template <typename K, typename V, typename Hash>
 double GDSFCache<K, V, Hash>::count() const {
     std::shared_lock<std::shared_mutex> lock(const_cast<std::shared_mutex&>(mtx_));
-    return priority_queue_.size();
+    return lookup_table_.size();
 }
 
 template <typename K, typename V, typename Hash>
@@ -105,9 +105,8 @@ void GDSFCache<K, V, Hash>::erase(const K& key) {
         return;
     }
 
-    const auto& node_iterator = it->second;
-    current_size_ -= node_iterator->size;
-    priority_queue_.erase(node_iterator);
+    current_size_ -= it->second.size;
+    heap_.remove(it->second.heap_index);
     lookup_table_.erase(it);
 }
 
@@ -116,27 +115,27 @@ double GDSFCache<K, V, Hash>::calculate_priority(size_t frequency, size_t size)
     return l_value_ + static_cast<double>(frequency) / size;
 }
 
-
-
 template <typename K, typename V, typename Hash>
 void GDSFCache<K, V, Hash>::evict(size_t needed_space) {
-    while (current_size_ + needed_space > capacity_ && !priority_queue_.empty()) {
-        auto it_to_evict = priority_queue_.begin();
-        const auto& node_to_evict = *it_to_evict;
+    while (current_size_ + needed_space > capacity_ && !heap_.empty()) {
+        Node* node_to_evict = heap_.top().node;
+
+        // The top entry's key is a lower bound for every node's priority.
+        // If the top node was hit since its last sift, refresh and sink it;
+        // once the top is current it is the true minimum.
+        if (heap_.top().priority < node_to_evict->priority) {
+            heap_.update(0, node_to_evict->priority);
+            continue;
+        }
 
         // core
-        l_value_ = node_to_evict.priority;
+        l_value_ = node_to_evict->priority;
 
         // update
-        current_size_ -= node_to_evict.size;
-        priority_queue_.erase(it_to_evict);
-        lookup_table_.erase(node_to_evict.key);
+        current_size_ -= node_to_evict->size;
+        heap_.remove(0);
+        lookup_table_.erase(lookup_table_.find(node_to_evict->key));
     }
 }
 
-
-
-
-
-
-} // namespace GDSF
\ No newline at end of file
+} // namespace GDSF
@@ -1,23 +1,45 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-8-18 21:15:36
+@LastEditTime: 2026-10-16 13:10:42
 @Description: LIRS缓存实现
 @Language: C++17
 */
 
 #include "../../include/LIRS/cache.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <cstdint>
 
 namespace LIRS {
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
-LIRSCache<K, V, Hash>::LIRSCache(size_t capacity)
-    : capacity_(capacity), size_(0), lir_size_(0), hir_size_(0) {
+/*
+ * Canonical LIRS (Jiang & Zhang). A resident HIR block is promoted exactly
+ * when it is hit while still in S: S is pruned so its bottom is the oldest
+ * LIR block, so membership in S means the new IRR is smaller than that
+ * block's recency. Membership is a flag on the node, and pruning only pops
+ * from the bottom, so every operation is O(1) amortized.
+ *
+ * Non-resident HIR blocks are not kept as nodes. S holds resident blocks
+ * only, and an evicted block leaves a ghost record of its key hash and the
+ * recency stamp it had in S. Since S is ordered by recency and cut at its
+ * bottom, the ghost is still "in S" iff that stamp is newer than the bottom
+ * block's. Ghosts are capped (2x capacity by default) and dropped oldest
+ * first, so memory stays proportional to capacity under scans. A hash
+ * collision can at worst promote a new block as if it were a ghost hit.
+ */
+
+template <typename K, typename V, typename Hash>
+LIRSCache<K, V, Hash>::LIRSCache(size_t capacity, size_t max_ghosts)
+    : capacity_(capacity), size_(0), lir_size_(0), hir_size_(0), max_ghosts_(max_ghosts), clock_(0) {
     if (capacity_ == 0) {
         throw std::invalid_argument("capacity must be greater than 0");
     }
+    /* LIR_RATIO of the blocks are LIR, but Q always keeps at least one slot */
+    lir_capacity_ = std::min(capacity_ - 1, static_cast<size_t>(capacity_ * LIR_RATIO));
+    if (max_ghosts_ == 0) {
+        max_ghosts_ = 2 * capacity_;
+    }
     
     /* create sentinel nodes for S stack and Q queue */
     lir_head_ = new LIRSNode<K, V>(K(), V());
@@ -31,175 +53,150 @@ LIRSCache<K, V, Hash>::LIRSCache(size_t capacity)
     hir_head_->prev_q = hir_head_;
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 LIRSCache<K, V, Hash>::~LIRSCache() {
     clear();
     delete lir_head_;
     delete hir_head_;
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 void LIRSCache<K, V, Hash>::put(const K& key, const V& value) {
     // write lock
     std::unique_lock<std::mutex> write_lock(mtx_);
 
-    /* a new key */
-    if (!contains(key)) {
-        /* cache is full, need to evict */
-        if (size_ >= capacity_) {
-            evict_victim();
-        }
-        
-        /* create new node */
-        LIRSNode<K, V> *node = new LIRSNode<K, V>(key, value);
-        
-        /* add to hash map */
-        key_to_node_[key] = node;
-        size_++;
-        
-        /* check if we have space in LIR set */
-        size_t max_lir_size = static_cast<size_t>(capacity_ * LIR_RATIO);
-        if (lir_size_ < max_lir_size) {
-            /* add as LIR block */
-            node->is_LIRS = true;
-            node->is_resident = true;
-            push_to_s(node);
-            lir_size_++;
-        } else {
-            /* add as HIR block */
-            node->is_LIRS = false;
-            node->is_resident = true;
-            push_to_s(node);
-            push_to_q(node);
-            hir_size_++;
-        }
-        
-        prune_s_stack();
-    } else {
-        /* existing key - update value */
-        LIRSNode<K, V> *node = key_to_node_[key];
+    LIRSNode<K, V> *node = find_node(key);
+
+    /* resident block - update value and count the reference */
+    if (node != nullptr) {
         node->value = value;
+        access(node);
+        return;
+    }
 
-        if (node->is_LIRS) {        
-            /* LIR block: move to top of S stack */
-            node->remove_from_s();
-            push_to_s(node);
-            /* prune S stack to maintain LIR property */
-            prune_s_stack();
-        } else if (node->is_resident) {                    
-            /* HIR resident block: check for promotion */
-            /* 计算HIR节点移动前的原始距离 */
-            size_t hir_original_distance = get_distance_from_head(node);
-            
-            node->remove_from_s();
-            node->remove_from_q();
-            
-            /* check if this HIR block should be promoted to LIR */
-            if (should_promote_to_lir(node, hir_original_distance)) {
-                node->is_LIRS = true;
-                hir_size_--;
-                lir_size_++;
-                push_to_s(node);
-                
-                /* ensure LIR set doesn't exceed limit */
-                size_t max_lir_size = static_cast<size_t>(capacity_ * LIR_RATIO);
-                if (lir_size_ > max_lir_size) {
-                    demote_lir_to_hir();
-                }
-            } else {
-                /* still HIR, add back to Q */
-                push_to_s(node);
-                push_to_q(node);
-            }
-            prune_s_stack();
-        } else {
-            /* HIR non-resident block: make resident */
-            node->is_resident = true;
-            node->remove_from_s();
-            push_to_s(node);
-            push_to_q(node);
-            hir_size_++;
-            size_++;
-            prune_s_stack();
-        }
+    /* miss: check the history before eviction reshapes S */
+    bool ghost_in_s = take_ghost(key);
+
+    /* free a slot first, the victim is a resident HIR block */
+    if (size_ >= capacity_) {
+        evict_victim();
+    }
+
+    node = new LIRSNode<K, V>(key, value);
+    key_to_node_[key] = node;
+    size_++;
+
+    if (lir_size_ < lir_capacity_) {
+        /* LIR set not full yet: every block starts as LIR */
+        node->is_LIRS = true;
+        lir_size_++;
+        push_to_s(node);
+    } else if (ghost_in_s) {
+        /* non-resident HIR block still in S: its IRR beats the oldest LIR */
+        node->is_LIRS = true;
+        lir_size_++;
+        push_to_s(node);
+        demote_lir_to_hir();
+        prune_s_stack();
+    } else {
+        /* new (or forgotten) block: resident HIR */
+        node->is_LIRS = false;
+        hir_size_++;
+        push_to_s(node);
+        push_to_q(node);
     }
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 std::optional<V> LIRSCache<K, V, Hash>::get(const K& key) {
     // write lock
     std::unique_lock<std::mutex> write_lock(mtx_);
 
-    if (!contains(key)) {
-        return std::nullopt;
-    }
-
-    LIRSNode<K, V> *node = key_to_node_[key];
+    LIRSNode<K, V> *node = find_node(key);
     
-    /* only access resident blocks */
-    if (!node->is_resident) {
+    if (node == nullptr) {
         return std::nullopt;
     }
 
+    access(node);
+    return std::make_optional(node->value);
+}
+
+template <typename K, typename V, typename Hash>
+void LIRSCache<K, V, Hash>::access(LIRSNode<K, V> *node) {
     if (node->is_LIRS) {
-        /* LIR block: move to top of S stack */
-        node->remove_from_s();
+        /* LIR block: move to top of S stack, prune if it was the bottom */
+        bool was_bottom = node == lir_head_->prev_s;
+        remove_from_s(node);
         push_to_s(node);
-        prune_s_stack();
-    } else {
-        /* HIR block: check for promotion */
-        /* 计算HIR节点移动前的原始距离 */
-        size_t hir_original_distance = get_distance_from_head(node);
-        
-        node->remove_from_s();
+        if (was_bottom) {
+            prune_s_stack();
+        }
+    } else if (node->in_s) {
+        /* HIR block still in S: promote, the oldest LIR block takes its place in Q */
+        remove_from_s(node);
         node->remove_from_q();
-        
-        /* check if this HIR block should be promoted to LIR */
-        if (should_promote_to_lir(node, hir_original_distance)) {
-            node->is_LIRS = true;
-            hir_size_--;
-            lir_size_++;
-            push_to_s(node);
-            
-            /* ensure LIR set doesn't exceed limit */
-            size_t max_lir_size = static_cast<size_t>(capacity_ * LIR_RATIO);
-            if (lir_size_ > max_lir_size) {
-                demote_lir_to_hir();
-            }
-        } else {
-            /* still HIR, add back to Q */
-            push_to_s(node);
-            push_to_q(node);
+        node->is_LIRS = true;
+        hir_size_--;
+        lir_size_++;
+        push_to_s(node);
+        if (lir_size_ > lir_capacity_) {
+            demote_lir_to_hir();
         }
         prune_s_stack();
+    } else {
+        /* HIR block out of S: stays HIR, goes back to the top of S and end of Q */
+        push_to_s(node);
+        node->remove_from_q();
+        push_to_q(node);
     }
-
-    return std::make_optional(node->value);
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 bool LIRSCache<K, V, Hash>::contains(const K& key) const {
-    return key_to_node_.find(key) != key_to_node_.end();
+    std::unique_lock<std::mutex> lock(mtx_);
+    return find_node(key) != nullptr;
+}
+
+template <typename K, typename V, typename Hash>
+LIRSNode<K, V>* LIRSCache<K, V, Hash>::find_node(const K& key) const {
+    auto it = key_to_node_.find(key);
+    return it == key_to_node_.end() ? nullptr : it->second;
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 size_t LIRSCache<K, V, Hash>::size() const {
     return size_;
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 size_t LIRSCache<K, V, Hash>::capacity() const {
     return capacity_;
 }
 
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 bool LIRSCache<K, V, Hash>::empty() const {
     return size_ == 0;
 }
 
+template <typename K, typename V, typename Hash>
+size_t LIRSCache<K, V, Hash>::lir_size() const {
+    return lir_size_;
+}
+
+template <typename K, typename V, typename Hash>
+size_t LIRSCache<K, V, Hash>::hir_size() const {
+    return hir_size_;
+}
+
+template <typename K, typename V, typename Hash>
+size_t LIRSCache<K, V, Hash>::ghost_size() const {
+    return ghosts_.size();
+}
+
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 void LIRSCache<K, V, Hash>::clear() {
     std::unique_lock<std::mutex> write_lock(mtx_);
 
@@ -207,6 +204,8 @@ void LIRSCache<K, V, Hash>::clear() {
         delete node;
     }
     key_to_node_.clear();
+    ghosts_.clear();
+    ghost_fifo_.clear();
     
     /* reset sentinel nodes */
     lir_head_->next_s = lir_head_;
@@ -221,143 +220,135 @@ void LIRSCache<K, V, Hash>::clear() {
 }
 
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 void LIRSCache<K, V, Hash>::push_to_s(LIRSNode<K, V> *node) {
     node->next_s = lir_head_->next_s;
     node->prev_s = lir_head_;
     node->next_s->prev_s = node;
     node->prev_s->next_s = node;
+    node->in_s = true;
+    node->recency = ++clock_;
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
+void LIRSCache<K, V, Hash>::remove_from_s(LIRSNode<K, V> *node) {
+    node->remove_from_s();
+    node->in_s = false;
+}
+
+template <typename K, typename V, typename Hash>
 void LIRSCache<K, V, Hash>::push_to_q(LIRSNode<K, V> *node) {
-    node->next_q = hir_head_->next_q;
-    node->prev_q = hir_head_;
+    node->next_q = hir_head_;
+    node->prev_q = hir_head_->prev_q;
     node->next_q->prev_q = node;
     node->prev_q->next_q = node;
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 void LIRSCache<K, V, Hash>::evict_victim() {
     /* evict HIR block from front of Q queue */
-    if (hir_head_->next_q != hir_head_) {
-        LIRSNode<K, V> *victim = hir_head_->next_q;
-        victim->remove_from_q();
-        victim->is_resident = false;
-        hir_size_--;
-        size_--;
-        
-        /* keep non-resident HIR block in S stack for history */
-        /* it will be cleaned up during pruning */
+    if (hir_head_->next_q == hir_head_) {
+        return;
     }
+
+    LIRSNode<K, V> *victim = hir_head_->next_q;
+    victim->remove_from_q();
+    hir_size_--;
+    size_--;
+
+    /* while in S it stays history, as a compact ghost; out of S it is forgotten */
+    if (victim->in_s) {
+        remove_from_s(victim);
+        add_ghost(victim);
+    }
+    key_to_node_.erase(victim->key);
+    delete victim;
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 void LIRSCache<K, V, Hash>::prune_s_stack() {
-    /* remove non-resident HIR blocks from bottom of S stack */
+    /* pop HIR blocks off the bottom of S until the bottom is LIR */
     LIRSNode<K, V> *node = lir_head_->prev_s;
     
-    while (node != lir_head_) {
+    while (node != lir_head_ && !node->is_LIRS) {
         LIRSNode<K, V> *prev = node->prev_s;
-        
-        if (!node->is_resident && !node->is_LIRS) {
-            /* non-resident HIR block - remove from stack and delete */
-            node->remove_from_s();
-            key_to_node_.erase(node->key);
-            delete node;
-        } else if (node->is_LIRS) {
-            /* reached LIR block - stop pruning */
-            break;
-        } else {
-            /* resident HIR block - stop pruning */
-            break;
-        }
-        
+        remove_from_s(node);
         node = prev;
     }
+    prune_ghosts();
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
+template <typename K, typename V, typename Hash>
 void LIRSCache<K, V, Hash>::demote_lir_to_hir() {
-    /* 
-     * 降级距离lir_head_最远的LIR节点为HIR
-     * 这与should_promote_to_lir中的逻辑保持一致
-     */
-    
-    // 找到距离lir_head_最远的LIR节点（从栈底向上找第一个LIR节点）
-    LIRSNode<K, V> *node = lir_head_->prev_s;  // 栈底开始
-    
-    while (node != lir_head_) {
-        if (node->is_LIRS) {
-            /* 降级这个最远的LIR节点为HIR */
-            node->is_LIRS = false;
-            lir_size_--;
-            hir_size_++;
-            
-            /* 添加到Q队列 */
-            push_to_q(node);
-            break;
-        }
-        node = node->prev_s;
+    /* the bottom of a pruned S is the LIR block with the largest recency */
+    LIRSNode<K, V> *node = lir_head_->prev_s;
+    if (node == lir_head_ || !node->is_LIRS) {
+        return;
     }
+
+    remove_from_s(node);
+    node->is_LIRS = false;
+    lir_size_--;
+    hir_size_++;
+    push_to_q(node);
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
-size_t LIRSCache<K, V, Hash>::get_distance_from_head(LIRSNode<K, V> *target_node) {
-    /* 计算指定节点距离lir_head_的距离 */
-    LIRSNode<K, V> *current = lir_head_->next_s;  // 从栈顶开始
-    size_t distance = 1;
-    
-    while (current != lir_head_) {
-        if (current == target_node) {
-            return distance;
+template <typename K, typename V, typename Hash>
+uint64_t LIRSCache<K, V, Hash>::bottom_recency() const {
+    /* an empty S has no bottom: every ghost counts as out of it */
+    return lir_head_->prev_s == lir_head_ ? UINT64_MAX : lir_head_->prev_s->recency;
+}
+
+template <typename K, typename V, typename Hash>
+void LIRSCache<K, V, Hash>::add_ghost(LIRSNode<K, V> *node) {
+    size_t hash = hasher_(node->key);
+    ghosts_[hash] = node->recency;
+    ghost_fifo_.push_back({hash, node->recency});
+
+    /* over the bound: forget the oldest records, stale ones count too */
+    while (ghost_fifo_.size() > max_ghosts_) {
+        GhostRecord oldest = ghost_fifo_.front();
+        ghost_fifo_.pop_front();
+        auto it = ghosts_.find(oldest.hash);
+        if (it != ghosts_.end() && it->second == oldest.recency) {
+            ghosts_.erase(it);
         }
-        current = current->next_s;
-        distance++;
     }
-    
-    return SIZE_MAX;  // 节点不在S栈中
 }
 
-template <typename K, typename V, typename Hash = std::hash<std::string>>
-bool LIRSCache<K, V, Hash>::should_promote_to_lir(LIRSNode<K, V> *hir_node, size_t hir_original_distance) {
-    size_t max_lir_size = static_cast<size_t>(capacity_ * LIR_RATIO);
-    
-    /* Always promote if there's space in LIR set */
-    if (lir_size_ < max_lir_size) {
-        return true;
+template <typename K, typename V, typename Hash>
+bool LIRSCache<K, V, Hash>::take_ghost(const K& key) {
+    auto it = ghosts_.find(hasher_(key));
+    if (it == ghosts_.end()) {
+        return false;
     }
-    
-    /* 
-     * 当HIR节点距离lir_head_的距离比最远的LIR节点要近时，提升HIR为LIR
-     * 距离定义为在S栈中从head开始的位置
+    bool in_s = it->second > bottom_recency();
+    ghosts_.erase(it);
+    return in_s;
+}
+
+template <typename K, typename V, typename Hash>
+void LIRSCache<K, V, Hash>::prune_ghosts() {
+    /*
+     * Records older than the bottom of S have left S and would never be
+     * promoted. Eviction follows Q rather than recency, so the queue is only
+     * roughly ordered: drop from the front while the front is stale, and let
+     * the rest go when they reach it or are looked up. Consumed ghosts leave
+     * stale queue entries behind, which are skipped the same way.
      */
-    
-    // 找到距离lir_head_最远的LIR节点（从栈底向上找第一个LIR节点）
-    LIRSNode<K, V> *farthest_lir = nullptr;
-    size_t farthest_lir_distance = 0;
-    
-    // 从栈底开始向上找最远的LIR节点
-    LIRSNode<K, V> *current = lir_head_->prev_s;  // 栈底
-    size_t distance = 1;
-    
-    while (current != lir_head_) {
-        if (current->is_LIRS) {
-            farthest_lir = current;
-            farthest_lir_distance = distance;
-            break;  // 找到第一个（最远的）LIR节点就停止
+    uint64_t bottom = bottom_recency();
+    while (!ghost_fifo_.empty()) {
+        const GhostRecord& oldest = ghost_fifo_.front();
+        auto it = ghosts_.find(oldest.hash);
+        bool live = it != ghosts_.end() && it->second == oldest.recency;
+        if (live && oldest.recency > bottom) {
+            break;
         }
-        current = current->prev_s;
-        distance++;
-    }
-    
-    if (farthest_lir == nullptr) {
-        return false;  // 没有找到LIR节点，不应该发生
+        if (live) {
+            ghosts_.erase(it);
+        }
+        ghost_fifo_.pop_front();
     }
-    
-    // 使用HIR节点移动之前的原始距离进行比较
-    // 如果HIR节点原始距离更近（距离值更小），则提升
-    return hir_original_distance < farthest_lir_distance;
 }
 
-} // namespace LIRS
\ No newline at end of file
+} // namespace LIRS
@@ -1,26 +1,67 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:57:41
+@LastEditTime: 2025-11-13 20:58:35
 @Description: MGLRU Access Tracker Implementation
 @Language: C++17
 */
 
 #include "access_tracker.h"
 
-AccessTracker::AccessTracker(size_t size) 
-    : bitset_(size), size_mask_(size - 1) {
-    // size must be power of 2
-    // size_mask is used for quick modulo operation
+namespace {
+
+size_t words_for(size_t num_pages) {
+    return (num_pages + AccessTracker::PAGES_PER_WORD - 1) / AccessTracker::PAGES_PER_WORD;
+}
+
+} // namespace
+
+AccessTracker::AccessTracker(size_t num_pages) 
+    : bitset_(new BitSet[words_for(num_pages)]),
+      num_words_(words_for(num_pages)),
+      num_pages_(num_pages) {
+    clear();
 }
 
 void AccessTracker::set(PageFrameId page_id) {
-    size_t idx = (page_id >> 6) & size_mask_;  // divide by 64 to get bitset index
-    size_t bit = page_id & 0x3F;                // mod 64 to get bit position
-    bitset_[idx].fetch_or(1ULL << bit, std::memory_order_relaxed);
+    if (page_id >= num_pages_) {
+        return;
+    }
+    size_t idx = page_id >> 6;      // divide by 64 to get bitset index
+    size_t bit = page_id & 0x3F;    // mod 64 to get bit position
+    uint64_t mask = 1ULL << bit;
+    // skip the RMW when already set, keeps the cache line shared on hot pages
+    if ((bitset_[idx].load(std::memory_order_relaxed) & mask) == 0) {
+        bitset_[idx].fetch_or(mask, std::memory_order_relaxed);
+    }
+}
+
+void AccessTracker::set_range(PageFrameId first_page, uint64_t mask) {
+    size_t idx = first_page >> 6;
+    if (idx >= num_words_) {
+        return;
+    }
+    // bits past the end of the pool stay clear
+    if (idx == num_words_ - 1 && num_pages_ % PAGES_PER_WORD != 0) {
+        mask &= (1ULL << (num_pages_ % PAGES_PER_WORD)) - 1;
+    }
+    if ((bitset_[idx].load(std::memory_order_relaxed) & mask) != mask) {
+        bitset_[idx].fetch_or(mask, std::memory_order_relaxed);
+    }
+}
+
+bool AccessTracker::test(PageFrameId page_id) const {
+    if (page_id >= num_pages_) {
+        return false;
+    }
+    uint64_t mask = 1ULL << (page_id & 0x3F);
+    return (bitset_[page_id >> 6].load(std::memory_order_relaxed) & mask) != 0;
 }
 
 bool AccessTracker::check_and_clear(PageFrameId page_id) {
-    size_t idx = (page_id >> 6) & size_mask_;
+    if (page_id >= num_pages_) {
+        return false;
+    }
+    size_t idx = page_id >> 6;
     size_t bit = page_id & 0x3F;
     uint64_t mask = 1ULL << bit;
     
@@ -29,9 +70,35 @@ bool AccessTracker::check_and_clear(PageFrameId page_id) {
     return (old_val & mask) != 0;
 }
 
+uint64_t AccessTracker::test_and_clear_range(PageFrameId first_page, uint64_t mask) {
+    size_t idx = first_page >> 6;
+    if (idx >= num_words_) {
+        return 0;
+    }
+    uint64_t old_val = bitset_[idx].fetch_and(~mask, std::memory_order_acq_rel);
+    return old_val & mask;
+}
+
 void AccessTracker::clear() {
-    for (auto& bits : bitset_) {
-        bits.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < num_words_; ++i) {
+        bitset_[i].store(0, std::memory_order_relaxed);
     }
 }
 
+void AccessTracker::resize(size_t num_pages) {
+    size_t new_words = words_for(num_pages);
+    std::unique_ptr<BitSet[]> bits(new BitSet[new_words]);
+    for (size_t i = 0; i < new_words; ++i) {
+        bits[i].store(i < num_words_ ? bitset_[i].load(std::memory_order_relaxed) : 0,
+                      std::memory_order_relaxed);
+    }
+    // drop bits of frames beyond a shrunken pool
+    if (num_pages % PAGES_PER_WORD != 0 && new_words > 0) {
+        uint64_t keep = (1ULL << (num_pages % PAGES_PER_WORD)) - 1;
+        bits[new_words - 1].store(bits[new_words - 1].load(std::memory_order_relaxed) & keep,
+                                  std::memory_order_relaxed);
+    }
+    bitset_ = std::move(bits);
+    num_words_ = new_words;
+    num_pages_ = num_pages;
+}
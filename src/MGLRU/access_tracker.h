@@ -1,6 +1,6 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:58:02
+@LastEditTime: 2025-11-13 20:41:17
 @Description: MGLRU Access Tracker Implementation
 @Language: C++17
 */
@@ -10,16 +10,20 @@
 
 #include "mglru_types.h"
 
-#include <vector>
 #include <atomic>
 #include <cstddef>
+#include <memory>
 
 using BitSet = std::atomic<uint64_t>;
 
+// Dense accessed-bit map with exactly one bit per page frame, the software
+// counterpart of the PTE accessed bit. Bit i of word w belongs to frame 64*w+i.
 class AccessTracker {
 public:
-    // size is the power of 2
-    explicit AccessTracker(size_t size);
+    static constexpr size_t PAGES_PER_WORD = 64;
+
+    // num_pages is the size of the frame pool
+    explicit AccessTracker(size_t num_pages);
     ~AccessTracker() = default;
     
     // Disable copy (atomic is not copyable)
@@ -30,19 +34,37 @@ public:
     AccessTracker(AccessTracker&&) = default;
     AccessTracker& operator=(AccessTracker&&) = default;
 
-    // set visited bit for the page frame
+    // set visited bit for the page frame, frames outside the pool are ignored
     void set(PageFrameId page_id);
 
+    // set the visited bits in `mask` for the 64 frames starting at the
+    // 64-aligned first_page in one atomic op
+    void set_range(PageFrameId first_page, uint64_t mask);
+
+    // read the visited bit without clearing it
+    bool test(PageFrameId page_id) const;
+
     // check if the page frame is visited and clear the visited bit
     // atomic operation
     bool check_and_clear(PageFrameId page_id);
 
+    // check and clear the visited bits of the 64 frames starting at the
+    // 64-aligned first_page in one atomic op; only bits in `mask` are cleared.
+    // Bit i of the result belongs to frame first_page + i.
+    uint64_t test_and_clear_range(PageFrameId first_page, uint64_t mask = ~0ULL);
+
     // clear all the visited bits
     void clear();
 
+    // grow or shrink the pool, keeping existing bits; not thread-safe
+    void resize(size_t num_pages);
+
+    size_t size() const { return num_pages_; }
+
 private:
-    std::vector<BitSet> bitset_;
-    size_t size_mask_; // quick mask to get the index of the bit set
+    std::unique_ptr<BitSet[]> bitset_;
+    size_t num_words_;
+    size_t num_pages_;
 };
 
-#endif
\ No newline at end of file
+#endif
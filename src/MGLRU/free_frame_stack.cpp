@@ -0,0 +1,58 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-18 20:40:45
+@Description: MGLRU Lock-free Free Frame Stack Implementation
+@Language: C++17
+*/
+
+#include "free_frame_stack.h"
+
+FreeFrameStack::FreeFrameStack(size_t capacity)
+    : next_(new std::atomic<PageIndex>[capacity]),
+      head_(INVALID_PAGE) {
+    for (size_t i = 0; i < capacity; ++i) {
+        next_[i].store(INVALID_PAGE, std::memory_order_relaxed);
+    }
+}
+
+void FreeFrameStack::push_batch(const PageFrameId* page_ids, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    // link the batch privately, only its tail touches the shared head
+    for (size_t i = 0; i + 1 < count; ++i) {
+        next_[page_ids[i]].store(static_cast<PageIndex>(page_ids[i + 1]), std::memory_order_relaxed);
+    }
+    const PageIndex first = static_cast<PageIndex>(page_ids[0]);
+    std::atomic<PageIndex>& last_next = next_[page_ids[count - 1]];
+
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    do {
+        last_next.store(index_of(head), std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, make_head(head, first),
+                                          std::memory_order_release, std::memory_order_relaxed));
+}
+
+size_t FreeFrameStack::pop_batch(PageFrameId* out, size_t max_count) {
+    if (max_count == 0) {
+        return 0;
+    }
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (true) {
+        // Walk up to max_count links. They may change under us if another
+        // thread wins the race, in which case the tagged CAS fails and we retry.
+        size_t count = 0;
+        PageIndex cur = index_of(head);
+        while (cur != INVALID_PAGE && count < max_count) {
+            out[count++] = cur;
+            cur = next_[cur].load(std::memory_order_relaxed);
+        }
+        if (count == 0) {
+            return 0;
+        }
+        if (head_.compare_exchange_weak(head, make_head(head, cur),
+                                        std::memory_order_acquire, std::memory_order_acquire)) {
+            return count;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-18 20:22:07
+@Description: MGLRU Lock-free Free Frame Stack Implementation
+@Language: C++17
+*/
+
+#ifndef FREE_FRAME_STACK_H
+#define FREE_FRAME_STACK_H
+
+#include "mglru_types.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Lock-free LIFO of free frame IDs (Treiber stack). The links live in a
+// per-frame array, so push and pop never allocate; the head carries a
+// 32-bit tag next to the 32-bit frame index to defeat ABA.
+// Batched push/pop move a whole chain with a single CAS.
+class FreeFrameStack {
+public:
+    // room for frames 0..capacity-1, starts empty
+    explicit FreeFrameStack(size_t capacity);
+
+    FreeFrameStack(const FreeFrameStack&) = delete;
+    FreeFrameStack& operator=(const FreeFrameStack&) = delete;
+
+    void push(PageFrameId page_id) { push_batch(&page_id, 1); }
+    void push_batch(const PageFrameId* page_ids, size_t count);
+
+    // pop up to max_count frames into out, returns how many were popped
+    size_t pop_batch(PageFrameId* out, size_t max_count);
+
+    bool empty() const { return index_of(head_.load(std::memory_order_acquire)) == INVALID_PAGE; }
+
+private:
+    static PageIndex index_of(uint64_t head) { return static_cast<PageIndex>(head); }
+    static uint64_t make_head(uint64_t old_head, PageIndex index) {
+        return (((old_head >> 32) + 1) << 32) | index;
+    }
+
+    std::unique_ptr<std::atomic<PageIndex>[]> next_;
+    std::atomic<uint64_t> head_;
+};
+
+#endif
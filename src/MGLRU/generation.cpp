@@ -1,31 +1,63 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:57:07
+@LastEditTime: 2025-11-12 21:34:52
 @Description: MGLRU Generation Implementation
 @Language: C++17
 */
 
 #include "generation.h"
 
-Generation::Generation(size_t index, size_t tracker_size) 
-    : index_(index), tracker_(tracker_size) {
+Generation::Generation(size_t index) 
+    : index_(index) {
 }
 
-std::list<PageFrameId>::iterator Generation::add_page(PageFrameId page_id) {
+void Generation::add_page(PageTable& table, PageFrameId page_id) {
     // add page to the head (most recently used)
-    pages_.push_front(page_id);
-    return pages_.begin();
+    const PageIndex idx = static_cast<PageIndex>(page_id);
+    PageMetadata& meta = table[idx];
+    meta.prev = INVALID_PAGE;
+    meta.next = head_;
+    if (head_ != INVALID_PAGE) {
+        table[head_].prev = idx;
+    } else {
+        tail_ = idx;
+    }
+    head_ = idx;
+    ++size_;
 }
 
-void Generation::remove_page(std::list<PageFrameId>::iterator it) {
-    pages_.erase(it);
+void Generation::remove_page(PageTable& table, PageFrameId page_id) {
+    const PageIndex idx = static_cast<PageIndex>(page_id);
+    PageMetadata& meta = table[idx];
+    if (meta.prev != INVALID_PAGE) {
+        table[meta.prev].next = meta.next;
+    } else {
+        head_ = meta.next;
+    }
+    if (meta.next != INVALID_PAGE) {
+        table[meta.next].prev = meta.prev;
+    } else {
+        tail_ = meta.prev;
+    }
+    meta.prev = INVALID_PAGE;
+    meta.next = INVALID_PAGE;
+    --size_;
 }
 
-AccessTracker& Generation::get_tracker() {
-    return tracker_;
-}
+void Generation::absorb(PageTable& table, Generation& older) {
+    if (older.size_ == 0) {
+        return;
+    }
+    if (tail_ != INVALID_PAGE) {
+        table[tail_].next = older.head_;
+        table[older.head_].prev = tail_;
+    } else {
+        head_ = older.head_;
+    }
+    tail_ = older.tail_;
+    size_ += older.size_;
 
-std::list<PageFrameId>& Generation::get_pages() {
-    return pages_;
+    older.head_ = INVALID_PAGE;
+    older.tail_ = INVALID_PAGE;
+    older.size_ = 0;
 }
-
@@ -1,6 +1,6 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:15:36
+@LastEditTime: 2025-11-12 21:20:15
 @Description: MGLRU缓存实现
 @Language: C++17
 */
@@ -8,17 +8,19 @@
 #ifndef GENERATION_H
 #define GENERATION_H
 
-#include "access_tracker.h"
+#include "mglru_types.h"
 
-#include <list>
 #include <memory>
 
+// A generation is an intrusive doubly-linked list threaded through the
+// prev/next fields of the page table, so membership changes never allocate.
+// Accessed bits live in the MGLRU-wide AccessTracker, not per generation.
 class Generation {
 public:
-    Generation(size_t index, size_t tracker_size);
+    explicit Generation(size_t index);
     ~Generation() = default;
     
-    // Disable copy (contains non-copyable AccessTracker)
+    // Disable copy (the list nodes are owned by the page table)
     Generation(const Generation&) = delete;
     Generation& operator=(const Generation&) = delete;
     
@@ -27,22 +29,34 @@ public:
     Generation& operator=(Generation&&) = default;
     
     // add a page to the head of the current generation
-    std::list<PageFrameId>::iterator add_page(PageFrameId page_id);
+    void add_page(PageTable& table, PageFrameId page_id);
 
     // remove a page from the current generation
-    void remove_page(std::list<PageFrameId>::iterator it);
+    void remove_page(PageTable& table, PageFrameId page_id);
 
-    // get the access tracker of the current generation
-    AccessTracker& get_tracker();
+    // move all pages of `older` to the tail (oldest end) of this generation,
+    // O(1) in the number of pages
+    void absorb(PageTable& table, Generation& older);
 
-    // get the pages of the current generation
-    // to scan asynchronously
-    std::list<PageFrameId>& get_pages();
+    // most recently added page / least recently added page,
+    // INVALID_PAGE when empty; walk with PageMetadata::next / prev
+    PageIndex head() const { return head_; }
+    PageIndex tail() const { return tail_; }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // when the generation was opened as the youngest; every page in it was
+    // added or found referenced after that
+    MglruClock::time_point birth() const { return birth_; }
+    void set_birth(MglruClock::time_point birth) { birth_ = birth; }
 
 private:
     size_t index_;
-    std::list<PageFrameId> pages_;
-    AccessTracker tracker_;
+    PageIndex head_ = INVALID_PAGE;
+    PageIndex tail_ = INVALID_PAGE;
+    size_t size_ = 0;
+    MglruClock::time_point birth_{};
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -9,18 +9,22 @@
 #include "access_tracker.h"
 #include "generation.h"
 #include "pid_controller.h"
+#include "shadow_table.h"
+#include "free_frame_stack.h"
 #include "memory_manager.h"
+#include "numa_memory_manager.h"
 #include <gtest/gtest.h>
 #include <vector>
 #include <set>
 #include <chrono>
 #include <thread>
+#include <atomic>
 
 // Test AccessTracker functionality
 class AccessTrackerTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        tracker = std::make_unique<AccessTracker>(64);  // 64 bitsets
+        tracker = std::make_unique<AccessTracker>(64 * 256);  // 256 words
     }
     
     std::unique_ptr<AccessTracker> tracker;
@@ -78,60 +82,116 @@ TEST_F(AccessTrackerTest, ClearAll) {
     }
 }
 
+TEST_F(AccessTrackerTest, NoAliasingBetweenPages) {
+    // pages that used to share a hashed bit must stay independent
+    tracker->set(5);
+    EXPECT_FALSE(tracker->check_and_clear(5 + 64 * 64));
+    EXPECT_FALSE(tracker->test(6));
+    EXPECT_TRUE(tracker->check_and_clear(5));
+
+    // frames outside the pool are ignored
+    tracker->set(64 * 256);
+    EXPECT_FALSE(tracker->check_and_clear(64 * 256));
+}
+
+TEST_F(AccessTrackerTest, TestAndClearRange) {
+    tracker->set(128);
+    tracker->set(130);
+    tracker->set(191);
+    tracker->set(192);  // next word, untouched
+
+    // only the masked bits are harvested and cleared
+    EXPECT_EQ(tracker->test_and_clear_range(128, 1ULL << 2), 1ULL << 2);
+    EXPECT_FALSE(tracker->test(130));
+    EXPECT_TRUE(tracker->test(128));
+
+    EXPECT_EQ(tracker->test_and_clear_range(128), (1ULL << 0) | (1ULL << 63));
+    EXPECT_EQ(tracker->test_and_clear_range(128), 0u);
+    EXPECT_TRUE(tracker->check_and_clear(192));
+}
+
+TEST_F(AccessTrackerTest, ResizeKeepsBits) {
+    tracker->set(42);
+    tracker->resize(64 * 1024);
+    EXPECT_EQ(tracker->size(), 64u * 1024);
+    EXPECT_TRUE(tracker->test(42));
+    tracker->set(64 * 1000);
+    EXPECT_TRUE(tracker->check_and_clear(64 * 1000));
+}
+
 // Test Generation functionality
 class GenerationTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        gen = std::make_unique<Generation>(0, 64);
+        gen = std::make_unique<Generation>(0);
+        table.resize(1000);
+    }
+
+    // walk the intrusive list from head (youngest) to tail (oldest)
+    std::vector<PageFrameId> pages_of(const Generation& g) const {
+        std::vector<PageFrameId> pages;
+        for (PageIndex i = g.head(); i != INVALID_PAGE; i = table[i].next) {
+            pages.push_back(i);
+        }
+        return pages;
     }
     
     std::unique_ptr<Generation> gen;
+    PageTable table;
 };
 
 TEST_F(GenerationTest, AddAndRemovePage) {
     PageFrameId page_id = 100;
     
     // Add page
-    auto it = gen->add_page(page_id);
+    gen->add_page(table, page_id);
     
     // Check page is in the list
-    auto& pages = gen->get_pages();
-    EXPECT_EQ(pages.size(), 1);
-    EXPECT_EQ(pages.front(), page_id);
+    EXPECT_EQ(gen->size(), 1);
+    EXPECT_EQ(gen->head(), page_id);
+    EXPECT_EQ(gen->tail(), page_id);
     
     // Remove page
-    gen->remove_page(it);
-    EXPECT_EQ(pages.size(), 0);
+    gen->remove_page(table, page_id);
+    EXPECT_EQ(gen->size(), 0);
+    EXPECT_EQ(gen->head(), INVALID_PAGE);
+    EXPECT_EQ(gen->tail(), INVALID_PAGE);
 }
 
 TEST_F(GenerationTest, MultiplePages) {
     std::vector<PageFrameId> page_ids = {100, 200, 300};
-    std::vector<std::list<PageFrameId>::iterator> iterators;
     
     // Add pages
     for (auto page_id : page_ids) {
-        iterators.push_back(gen->add_page(page_id));
+        gen->add_page(table, page_id);
     }
     
-    auto& pages = gen->get_pages();
-    EXPECT_EQ(pages.size(), 3);
+    EXPECT_EQ(gen->size(), 3);
     
     // Pages should be in reverse order (LIFO)
-    auto it = pages.begin();
-    EXPECT_EQ(*it++, 300);
-    EXPECT_EQ(*it++, 200);
-    EXPECT_EQ(*it++, 100);
+    EXPECT_EQ(pages_of(*gen), (std::vector<PageFrameId>{300, 200, 100}));
+
+    // Removing from the middle keeps the links consistent in both directions
+    gen->remove_page(table, 200);
+    EXPECT_EQ(pages_of(*gen), (std::vector<PageFrameId>{300, 100}));
+    EXPECT_EQ(table[100].prev, 300u);
+    EXPECT_EQ(gen->tail(), 100u);
 }
 
-TEST_F(GenerationTest, TrackerIntegration) {
-    PageFrameId page_id = 100;
-    gen->add_page(page_id);
-    
-    // Set access bit
-    gen->get_tracker().set(page_id);
-    
-    // Check it's set
-    EXPECT_TRUE(gen->get_tracker().check_and_clear(page_id));
+TEST_F(GenerationTest, AbsorbOlderGeneration) {
+    Generation older(1);
+    older.add_page(table, 10);
+    older.add_page(table, 20);
+    gen->add_page(table, 30);
+
+    gen->absorb(table, older);
+
+    // absorbed pages go to the tail (oldest end) in their original order
+    ASSERT_EQ(gen->size(), 3);
+    EXPECT_EQ(pages_of(*gen), (std::vector<PageFrameId>{30, 20, 10}));
+    EXPECT_EQ(gen->tail(), 10u);
+    EXPECT_TRUE(older.empty());
+    EXPECT_EQ(older.head(), INVALID_PAGE);
 }
 
 // Test PidController functionality
@@ -169,12 +229,104 @@ TEST_F(PidControllerTest, MultipleUpdates) {
     }
 }
 
+TEST_F(PidControllerTest, StallsRaiseAndRefaultsLowerIntensity) {
+    size_t base = controller->get_scan_intensity();
+
+    PidController stalled(0.5, 0.1, 0.2);
+    for (int i = 0; i < 5; i++) {
+        stalled.update_metrics(0, 32, 32, 32);  // direct reclaim did half the work
+    }
+    EXPECT_GT(stalled.get_error(), 0.0);
+    EXPECT_GT(stalled.get_scan_intensity(), base);
+
+    PidController refaulting(0.5, 0.1, 0.2);
+    for (int i = 0; i < 5; i++) {
+        refaulting.update_metrics(16, 32, 32);  // half of the evictions came back
+    }
+    EXPECT_LT(refaulting.get_error(), 0.0);
+    EXPECT_LT(refaulting.get_scan_intensity(), base);
+}
+
+TEST_F(PidControllerTest, LowEfficiencyScansMore) {
+    PidController controller_a(0.5, 0.1, 0.2);
+    PidController controller_b(0.5, 0.1, 0.2);
+    for (int i = 0; i < 5; i++) {
+        controller_a.update_metrics(0, 100, 100);
+        controller_b.update_metrics(0, 100, 10);
+    }
+    EXPECT_LT(controller_b.get_efficiency(), controller_a.get_efficiency());
+    EXPECT_GT(controller_b.get_scan_intensity(), controller_a.get_scan_intensity());
+}
+
+TEST_F(PidControllerTest, DerivativeReactsToChange) {
+    // same integral and error, the derivative term alone separates the two
+    PidController pd_only(0.0, 0.0, 1.0);
+    pd_only.update_metrics(0, 32, 32, 32);
+    size_t rising = pd_only.get_scan_intensity();
+    pd_only.update_metrics(0, 32, 32, 32);
+    size_t steady = pd_only.get_scan_intensity();
+    EXPECT_GT(rising, steady);
+}
+
+// Test ShadowTable functionality
+TEST(ShadowTableTest, InsertLookupErase) {
+    ShadowTable table(100);
+    EXPECT_EQ(table.capacity(), 128u);
+
+    EXPECT_FALSE(table.lookup_and_erase(42).has_value());
+    table.insert(42, 7, PageClass::File, 3);
+    auto entry = table.lookup_and_erase(42);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->seq, 7u);
+    EXPECT_EQ(entry->page_class, PageClass::File);
+    EXPECT_EQ(entry->tier, 3u);
+
+    // the shadow is consumed by the refault
+    EXPECT_FALSE(table.lookup_and_erase(42).has_value());
+}
+
+TEST(ShadowTableTest, SeqDistanceWrapsAround) {
+    const uint64_t wrap = 1ULL << ShadowTable::SEQ_BITS;
+    ShadowTable table(16);
+    table.insert(9, wrap - 2);
+    auto entry = table.lookup_and_erase(9);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(ShadowTable::seq_distance(wrap + 1, entry->seq), 3u);
+    EXPECT_EQ(ShadowTable::seq_distance(5, 5), 0u);
+}
+
+TEST(ShadowTableTest, ClearDropsEntries) {
+    ShadowTable table(16);
+    table.insert(1, 1);
+    table.insert(2, 2);
+    table.clear();
+    EXPECT_FALSE(table.lookup_and_erase(1).has_value());
+    EXPECT_FALSE(table.lookup_and_erase(2).has_value());
+}
+
+TEST(ShadowTableTest, MostRecentShadowsSurvive) {
+    ShadowTable table(1024);
+    for (PageKey key = 0; key < 256; ++key) {
+        table.insert(key, key);
+    }
+    size_t found = 0;
+    for (PageKey key = 0; key < 256; ++key) {
+        auto entry = table.lookup_and_erase(key);
+        if (entry.has_value()) {
+            EXPECT_EQ(entry->seq, key);
+            ++found;
+        }
+    }
+    // lossy only on collisions, which are rare at 25% load
+    EXPECT_GT(found, 200u);
+}
+
 // Test MGLRU Core functionality
 class MGLRUTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        // 4 generations, 64 tracker size per generation
-        mglru = std::make_unique<MGLRU>(4, 64);
+        // 4 generations, page table grows with the frame IDs in use
+        mglru = std::make_unique<MGLRU>(4);
     }
     
     std::unique_ptr<MGLRU> mglru;
@@ -334,7 +486,318 @@ TEST_F(MGLRUTest, LargeNumberOfPages) {
     std::cout << "Total evicted: " << total_evicted << std::endl;
 }
 
+TEST_F(MGLRUTest, AgingAdvancesSequenceNumbers) {
+    EXPECT_EQ(mglru->get_min_seq(), 0u);
+    EXPECT_EQ(mglru->get_max_seq(), 3u);
+
+    mglru->on_page_added(1);
+
+    // oldest generation empty: every scan ages by bumping the sequence numbers
+    for (uint64_t i = 1; i <= 3; ++i) {
+        ReclaimResult result = mglru->scan_and_reclaim(10);
+        EXPECT_EQ(result.scanned_pages_count, 0u);
+        EXPECT_EQ(mglru->get_max_seq(), 3u + i);
+        EXPECT_EQ(mglru->get_min_seq(), i);
+    }
+
+    // the page added at seq 3 is now in the oldest generation
+    ReclaimResult result = mglru->scan_and_reclaim(10);
+    ASSERT_EQ(result.evicted_pages.size(), 1u);
+    EXPECT_EQ(result.evicted_pages[0], 1u);
+}
+
+TEST_F(MGLRUTest, AgingKeepsPagesAndOrder) {
+    // pages added in different generations must all survive aging and be
+    // evicted oldest first
+    for (PageFrameId id = 0; id < 8; ++id) {
+        mglru->on_page_added(id);
+        mglru->scan_and_reclaim(0);   // empty oldest generation -> age
+    }
+
+    std::vector<PageFrameId> evicted;
+    for (int round = 0; round < 20 && evicted.size() < 8; ++round) {
+        ReclaimResult result = mglru->scan_and_reclaim(1);
+        evicted.insert(evicted.end(), result.evicted_pages.begin(), result.evicted_pages.end());
+    }
+
+    ASSERT_EQ(evicted.size(), 8u);
+    for (PageFrameId id = 0; id < 8; ++id) {
+        EXPECT_EQ(evicted[id], id);
+    }
+}
+
+TEST_F(MGLRUTest, ReAddedPageDoesNotDuplicate) {
+    mglru->on_page_added(7);
+    mglru->on_page_added(7);
+
+    size_t evicted = 0;
+    for (int round = 0; round < 10; ++round) {
+        evicted += mglru->scan_and_reclaim(10).evicted_pages.size();
+    }
+    EXPECT_EQ(evicted, 1u);
+}
+
+TEST_F(MGLRUTest, RemovedPageIsNeverEvicted) {
+    for (PageFrameId id = 0; id < 4; ++id) {
+        mglru->on_page_added(id);
+    }
+    mglru->on_page_removed(2);
+    mglru->on_page_removed(2);  // removing twice is a no-op
+    EXPECT_EQ(mglru->size(), 3u);
+
+    std::vector<PageFrameId> evicted;
+    for (int round = 0; round < 10; ++round) {
+        auto result = mglru->scan_and_reclaim(10);
+        evicted.insert(evicted.end(), result.evicted_pages.begin(), result.evicted_pages.end());
+    }
+    EXPECT_EQ(evicted, (std::vector<PageFrameId>{0, 1, 3}));
+    EXPECT_EQ(mglru->size(), 0u);
+}
+
+TEST_F(MGLRUTest, AccessBitsAreExactPerPage) {
+    // 4096 shared a hashed bit with page 0 in the old 64-word tracker
+    mglru->on_page_added(0);
+    mglru->on_page_added(4096);
+    mglru->on_page_accessed(0);
+
+    // new pages need a few aging rounds to reach the oldest generation
+    std::vector<PageFrameId> evicted;
+    for (int round = 0; round < 6; ++round) {
+        auto result = mglru->scan_and_reclaim(1);
+        evicted.insert(evicted.end(), result.evicted_pages.begin(), result.evicted_pages.end());
+    }
+    EXPECT_EQ(evicted, std::vector<PageFrameId>{4096});
+}
+
+TEST_F(MGLRUTest, LookAroundPromotesHotNeighbours) {
+    for (PageFrameId id = 0; id < 8; ++id) {
+        mglru->on_page_added(id);
+    }
+    // 0 is at the tail; 5 and 6 share its word and are found in the same pass
+    mglru->on_page_accessed(0);
+    mglru->on_page_accessed(5);
+    mglru->on_page_accessed(6);
+
+    // age until the pages reach the oldest generation, then scan one page
+    ReclaimResult result = mglru->scan_and_reclaim(1);
+    for (int round = 0; round < 8 && result.scanned_pages_count == 0; ++round) {
+        result = mglru->scan_and_reclaim(1);
+    }
+    EXPECT_EQ(result.scanned_pages_count, 1u);
+    EXPECT_EQ(result.promoted_pages_count, 3u);
+    EXPECT_TRUE(result.evicted_pages.empty());
+}
+
+TEST_F(MGLRUTest, BatchedAccessesDeferListMoves) {
+    MGLRU lru(2, 256);
+    for (PageFrameId id = 0; id < 200; ++id) {
+        lru.on_page_added(id);
+    }
+    // every other page, spanning several bitmap words
+    std::vector<PageFrameId> hot;
+    for (PageFrameId id = 0; id < 200; id += 2) {
+        hot.push_back(id);
+    }
+    lru.record_accesses(hot.data(), hot.size());
+    lru.record_access(1000);  // outside the pool, ignored
+
+    // one full pass over the oldest generation, once the pages have aged into it
+    ReclaimResult result = lru.scan_and_reclaim(200);
+    for (int round = 0; round < 4 && result.scanned_pages_count == 0; ++round) {
+        result = lru.scan_and_reclaim(200);
+    }
+    // look-around harvests each word's hot pages at the first hit in it
+    EXPECT_EQ(result.scanned_pages_count, 100u + (200 + 63) / 64);
+    std::set<PageFrameId> evicted(result.evicted_pages.begin(), result.evicted_pages.end());
+    EXPECT_EQ(result.promoted_pages_count, hot.size());
+    for (PageFrameId id = 0; id < 200; ++id) {
+        EXPECT_EQ(evicted.count(id), id % 2) << id;
+    }
+}
+
+TEST_F(MGLRUTest, TierFollowsLogOfReferences) {
+    EXPECT_EQ(MGLRU::tier_of(0), 0u);
+    EXPECT_EQ(MGLRU::tier_of(1), 1u);
+    EXPECT_EQ(MGLRU::tier_of(2), 1u);
+    EXPECT_EQ(MGLRU::tier_of(3), 2u);
+    EXPECT_EQ(MGLRU::tier_of(6), 2u);
+    EXPECT_EQ(MGLRU::tier_of(7), 3u);
+    EXPECT_EQ(MGLRU::tier_of(255), 3u);
+}
+
+TEST_F(MGLRUTest, ClassWithFewerRefaultsIsEvictedFirst) {
+    // a single generation keeps every page in the oldest list and never decays
+    MGLRU lru(1);
+    for (PageFrameId id = 0; id < 10; ++id) {
+        lru.on_page_added(id, PageClass::Anon);
+        lru.on_page_added(id + 10, PageClass::File);
+    }
+    EXPECT_EQ(lru.size(PageClass::Anon), 10u);
+    EXPECT_EQ(lru.size(PageClass::File), 10u);
+
+    for (int i = 0; i < 5; ++i) {
+        lru.on_refault(PageClass::Anon, 0);
+    }
+    auto result = lru.scan_and_reclaim(5);
+    EXPECT_EQ(result.evicted_class, PageClass::File);
+    ASSERT_EQ(result.evicted_pages.size(), 5u);
+    for (auto id : result.evicted_pages) {
+        EXPECT_GE(id, 10u);
+    }
+    EXPECT_EQ(lru.get_tier_stats(PageClass::File, 0).evicted, 5u);
+
+    // file now refaults more often per eviction than anon
+    for (int i = 0; i < 40; ++i) {
+        lru.on_refault(PageClass::File, 0);
+    }
+    result = lru.scan_and_reclaim(5);
+    EXPECT_EQ(result.evicted_class, PageClass::Anon);
+    for (auto id : result.evicted_pages) {
+        EXPECT_LT(id, 10u);
+    }
+    EXPECT_EQ(lru.size(PageClass::Anon), 5u);
+}
+
+TEST_F(MGLRUTest, RefaultingTierIsProtected) {
+    MGLRU lru(1);
+    lru.on_page_added(0);
+    lru.on_page_accessed(0);
+    auto result = lru.scan_and_reclaim(1);  // found referenced once: tier 1
+    EXPECT_EQ(result.promoted_pages_count, 1u);
+
+    for (int i = 0; i < 3; ++i) {
+        lru.on_refault(PageClass::Anon, 1);
+    }
+    EXPECT_GT(lru.refault_rate(PageClass::Anon, 1), lru.refault_rate(PageClass::Anon, 0));
+
+    lru.on_page_added(1);
+    result = lru.scan_and_reclaim(10);
+    EXPECT_EQ(result.protected_pages_count, 1u);
+    EXPECT_EQ(result.evicted_pages, std::vector<PageFrameId>{1});
+    ASSERT_EQ(result.evicted_tiers.size(), 1u);
+    EXPECT_EQ(result.evicted_tiers[0], 0u);
+    EXPECT_EQ(lru.size(), 1u);
+}
+
+TEST_F(MGLRUTest, AgingWalkMovesYoungPages) {
+    MGLRU lru(4, 2 * PageTableRegions::PAGES_PER_REGION);
+    lru.set_aging_walk(AgingWalk::Full);
+    for (PageFrameId id = 0; id < 10; ++id) {
+        lru.on_page_added(id);
+    }
+    lru.on_page_accessed(3);
+    lru.age();
+
+    const WalkStats& stats = lru.get_walk_stats();
+    EXPECT_EQ(stats.walks, 1u);
+    EXPECT_EQ(stats.regions_walked, 1u);  // region 1 has no mapped frames
+    EXPECT_EQ(stats.regions_empty, 1u);
+    EXPECT_EQ(stats.young_pages, 1u);
+
+    // the walk consumed the accessed bit; page 3 now sits in the youngest
+    // generation and is the last one left once the others are evicted
+    std::vector<PageFrameId> evicted;
+    for (int round = 0; round < 10; ++round) {
+        auto result = lru.scan_and_reclaim(20);
+        EXPECT_EQ(result.promoted_pages_count, 0u);
+        evicted.insert(evicted.end(), result.evicted_pages.begin(), result.evicted_pages.end());
+    }
+    ASSERT_EQ(evicted.size(), 10u);
+    EXPECT_EQ(evicted.back(), 3u);
+}
+
+TEST_F(MGLRUTest, BloomFilteredWalkSkipsIdleRegions) {
+    constexpr size_t regions = 64;
+    constexpr size_t pages = regions * PageTableRegions::PAGES_PER_REGION;
+    const std::vector<size_t> hot_regions = {3, 40};
+
+    auto run = [&](AgingWalk mode) {
+        MGLRU lru(4, pages);
+        lru.set_aging_walk(mode);
+        for (PageFrameId id = 0; id < pages; ++id) {
+            lru.on_page_added(id);
+        }
+        for (int round = 0; round < 10; ++round) {
+            for (size_t region : hot_regions) {
+                for (PageFrameId i = 0; i < 16; ++i) {
+                    lru.record_access(PageTableRegions::first_page(region) + i * 7);
+                }
+            }
+            lru.age();
+        }
+        return lru.get_walk_stats();
+    };
+
+    WalkStats full = run(AgingWalk::Full);
+    WalkStats bloom = run(AgingWalk::Bloom);
+
+    // same young pages found, a fraction of the regions walked
+    EXPECT_EQ(full.young_pages, 10u * 2 * 16);
+    EXPECT_EQ(bloom.young_pages, full.young_pages);
+    EXPECT_EQ(full.regions_walked, 10u * regions);
+    EXPECT_LT(bloom.regions_walked, full.regions_walked / 4);
+    EXPECT_GT(bloom.regions_filtered, 0u);
+    std::cout << "Regions walked: full=" << full.regions_walked
+              << " bloom=" << bloom.regions_walked << std::endl;
+}
+
+TEST_F(MGLRUTest, FilteredRegionKeepsBitsForEviction) {
+    MGLRU lru(2, 4 * PageTableRegions::PAGES_PER_REGION);
+    lru.set_aging_walk(AgingWalk::Bloom);
+    const PageFrameId page = 2 * PageTableRegions::PAGES_PER_REGION + 5;
+    lru.on_page_added(0);
+    lru.on_page_added(page);
+
+    lru.age();  // first walk is unfiltered and finds nothing young
+    lru.record_access(page);
+    lru.age();  // region 2 was idle last time and is filtered out
+
+    const WalkStats& stats = lru.get_walk_stats();
+    EXPECT_EQ(stats.young_pages, 0u);
+    EXPECT_GT(stats.regions_filtered, 0u);
+
+    // the eviction scan still sees the bit
+    ReclaimResult result = lru.scan_and_reclaim(2);
+    for (int round = 0; round < 4 && result.scanned_pages_count == 0; ++round) {
+        result = lru.scan_and_reclaim(2);
+    }
+    EXPECT_EQ(result.evicted_pages, std::vector<PageFrameId>{0});
+    EXPECT_EQ(result.promoted_pages_count, 1u);
+}
+
 // Integration test
+TEST_F(MGLRUTest, WorkingSetCountsGenerationsBornInWindow) {
+    using std::chrono::seconds;
+    MglruClock::time_point now = MglruClock::now();
+    mglru->set_clock([&now] { return now; });
+
+    for (PageFrameId id = 0; id < 10; ++id) {
+        mglru->on_page_added(id);
+    }
+    now += seconds(10);
+    mglru->age();
+    for (PageFrameId id = 10; id < 15; ++id) {
+        mglru->on_page_added(id);
+    }
+    now += seconds(10);
+    mglru->age();
+
+    // youngest is empty, the 5 pages are 10s old, the first 10 are 20s old
+    EXPECT_EQ(mglru->working_set_pages(seconds(5)), 0u);
+    EXPECT_EQ(mglru->working_set_pages(seconds(15)), 5u);
+    EXPECT_EQ(mglru->working_set_pages(seconds(25)), 15u);
+
+    auto info = mglru->generation_info();
+    ASSERT_EQ(info.size(), 4u);
+    EXPECT_EQ(info.back().seq, mglru->get_max_seq());
+    EXPECT_EQ(info.front().seq, mglru->get_min_seq());
+    for (size_t i = 1; i < info.size(); ++i) {
+        EXPECT_LE(info[i - 1].birth, info[i].birth);
+    }
+    EXPECT_EQ(info[2].pages[class_index(PageClass::Anon)], 5u);
+    EXPECT_EQ(info.back().pages[0] + info.back().pages[1], 0u);
+}
+
 TEST_F(MGLRUTest, WorkloadSimulation) {
     std::cout << "\n=== Workload Simulation Test ===" << std::endl;
     
@@ -372,6 +835,61 @@ TEST_F(MGLRUTest, WorkloadSimulation) {
     }
 }
 
+// Test FreeFrameStack functionality
+TEST(FreeFrameStackTest, PushPopBatches) {
+    FreeFrameStack stack(16);
+    EXPECT_TRUE(stack.empty());
+
+    std::vector<PageFrameId> frames = {3, 7, 9, 1};
+    stack.push_batch(frames.data(), frames.size());
+    stack.push(12);
+
+    PageFrameId out[8];
+    ASSERT_EQ(stack.pop_batch(out, 2), 2u);
+    EXPECT_EQ(out[0], 12u);
+    EXPECT_EQ(out[1], 3u);
+    ASSERT_EQ(stack.pop_batch(out, 8), 3u);
+    EXPECT_EQ(out[0], 7u);
+    EXPECT_EQ(out[1], 9u);
+    EXPECT_EQ(out[2], 1u);
+    EXPECT_TRUE(stack.empty());
+    EXPECT_EQ(stack.pop_batch(out, 8), 0u);
+}
+
+TEST(FreeFrameStackTest, ConcurrentPushPopKeepsEveryFrame) {
+    constexpr size_t frames = 4096;
+    FreeFrameStack stack(frames);
+    for (PageFrameId id = 0; id < frames; ++id) {
+        stack.push(id);
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&stack, t]() {
+            PageFrameId batch[16];
+            for (int i = 0; i < 5000; ++i) {
+                size_t n = stack.pop_batch(batch, 1 + (i + t) % 16);
+                stack.push_batch(batch, n);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    std::vector<bool> seen(frames, false);
+    PageFrameId batch[64];
+    size_t total = 0;
+    while (size_t n = stack.pop_batch(batch, 64)) {
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_FALSE(seen[batch[i]]) << batch[i];
+            seen[batch[i]] = true;
+        }
+        total += n;
+    }
+    EXPECT_EQ(total, frames);
+}
+
 // Test MemoryManager functionality
 class MemoryManagerTest : public ::testing::Test {
 protected:
@@ -558,6 +1076,259 @@ TEST_F(MemoryManagerTest, ConcurrentAccess) {
     SUCCEED();
 }
 
+TEST_F(MemoryManagerTest, ConcurrentAccessWithAllocation) {
+    // 16 threads replay accesses while the main thread keeps allocating,
+    // which drives both direct and background reclaim
+    std::vector<PageFrameId> pages;
+    for (int i = 0; i < 50; ++i) {
+        auto page = manager->allocate_page();
+        ASSERT_TRUE(page.has_value());
+        pages.push_back(page.value());
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 16; ++t) {
+        threads.emplace_back([&, t]() {
+            size_t i = t;
+            while (!stop.load(std::memory_order_relaxed)) {
+                manager->access_page(pages[i % pages.size()]);
+                manager->access_pages(pages.data(), 8);
+                i += 7;
+            }
+        });
+    }
+
+    for (int i = 0; i < 2000; ++i) {
+        auto page = manager->allocate_page();
+        if (page.has_value() && i % 2 == 0) {
+            manager->free_page(page.value());
+        }
+    }
+    stop = true;
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    double usage = manager->get_memory_usage();
+    EXPECT_GE(usage, 0.0);
+    EXPECT_LE(usage, 1.0);
+}
+
+TEST_F(MemoryManagerTest, RefaultsAreDetectedOnReallocation) {
+    // stream 300 keys through a 100-frame pool, then touch the start again
+    // (a direct reclaim pass may find nothing to evict while generations age)
+    size_t allocated = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (PageKey key = 0; key < 300; ++key) {
+            allocated += manager->allocate_page(key).has_value();
+        }
+    }
+
+    MemoryStats stats = manager->get_stats();
+    EXPECT_EQ(stats.allocations, allocated);
+    EXPECT_GT(allocated, 300u);
+    EXPECT_GT(stats.refaults, 0u);
+    EXPECT_LE(stats.workingset_refaults, stats.refaults);
+
+    size_t histogram_total = 0;
+    for (size_t count : stats.refault_distance_histogram) {
+        histogram_total += count;
+    }
+    EXPECT_EQ(histogram_total, stats.refaults);
+    EXPECT_GT(stats.direct_reclaimed_pages + stats.kswapd_reclaimed_pages, 0u);
+}
+
+TEST_F(MemoryManagerTest, FreedPageLeavesNoShadow) {
+    auto page = manager->allocate_page(7);
+    ASSERT_TRUE(page.has_value());
+    manager->free_page(page.value());
+    manager->allocate_page(7);
+    EXPECT_EQ(manager->get_stats().refaults, 0u);
+}
+
+TEST_F(MemoryManagerTest, ReallocatedFrameDropsQueuedInsertion) {
+    // an anonymous page waits in the LRU add batch; freed and handed out
+    // again as a keyed Anon page, the frame must not be re-added as File
+    auto page = manager->allocate_page(PageClass::File);
+    ASSERT_TRUE(page.has_value());
+    manager->free_page(page.value());
+    auto again = manager->allocate_page(7, PageClass::Anon);
+    ASSERT_TRUE(again.has_value());
+    ASSERT_EQ(again.value(), page.value());
+
+    EXPECT_EQ(manager->proactive_reclaim(100 * PAGE_SIZE), PAGE_SIZE);
+    MemoryStats stats = manager->get_stats();
+    EXPECT_EQ(stats.evictions_by_class[class_index(PageClass::Anon)], 1u);
+    EXPECT_EQ(stats.evictions_by_class[class_index(PageClass::File)], 0u);
+}
+
+TEST_F(MemoryManagerTest, ClassHintSplitsStatistics) {
+    for (PageKey key = 0; key < 400; ++key) {
+        PageClass page_class = key % 2 ? PageClass::File : PageClass::Anon;
+        manager->allocate_page(key % 200, page_class);
+    }
+    MemoryStats stats = manager->get_stats();
+    EXPECT_EQ(stats.refaults_by_class[0] + stats.refaults_by_class[1], stats.workingset_refaults);
+    EXPECT_EQ(stats.evictions_by_class[0] + stats.evictions_by_class[1],
+              stats.direct_reclaimed_pages + stats.kswapd_reclaimed_pages);
+    EXPECT_GT(stats.evictions_by_class[0] + stats.evictions_by_class[1], 0u);
+}
+
+TEST_F(MemoryManagerTest, ProactiveReclaimEvictsColdPagesOnly) {
+    std::vector<PageFrameId> pages;
+    for (PageKey key = 0; key < 40; ++key) {
+        auto page = manager->allocate_page(key);
+        ASSERT_TRUE(page.has_value());
+        pages.push_back(page.value());
+    }
+    // keep the first 10 hot
+    std::vector<PageFrameId> hot(pages.begin(), pages.begin() + 10);
+    manager->access_pages(hot.data(), hot.size());
+
+    double usage_before = manager->get_memory_usage();
+    size_t reclaimed = manager->proactive_reclaim(20 * PAGE_SIZE);
+    EXPECT_EQ(reclaimed, 20 * PAGE_SIZE);
+    EXPECT_LT(manager->get_memory_usage(), usage_before);
+    EXPECT_EQ(manager->get_stats().proactive_reclaimed_pages, 20u);
+
+    // asking for more than is cold stops at the hot set
+    manager->access_pages(hot.data(), hot.size());
+    reclaimed = manager->proactive_reclaim(100 * PAGE_SIZE);
+    EXPECT_LE(reclaimed, 10 * PAGE_SIZE);
+    EXPECT_EQ(manager->get_stats().direct_reclaims, 0u);
+
+    EXPECT_EQ(manager->proactive_reclaim(0), 0u);
+}
+
+TEST_F(MemoryManagerTest, WorkingSetEstimateTracksRecentPages) {
+    using std::chrono::milliseconds;
+    MglruClock::time_point now = MglruClock::now();
+    manager->set_clock([&now] { return now; });
+
+    for (PageKey key = 0; key < 30; ++key) {
+        ASSERT_TRUE(manager->allocate_page(key).has_value());
+    }
+    auto estimate = manager->estimate_working_set(milliseconds(1000));
+    EXPECT_EQ(estimate.pages, 30u);
+    EXPECT_EQ(estimate.bytes, 30 * PAGE_SIZE);
+
+    auto estimates = manager->estimate_working_set({milliseconds(10), milliseconds(1000)});
+    ASSERT_EQ(estimates.size(), 2u);
+    EXPECT_EQ(estimates[0].window, milliseconds(10));
+    EXPECT_LE(estimates[0].pages, estimates[1].pages);
+}
+
+TEST_F(MemoryManagerTest, ConcurrentAllocationNeverSharesFrames) {
+    // every thread owns its frames until it frees them; a frame handed to
+    // two owners at once would trip the ownership flag
+    std::vector<std::atomic<int>> owner(100);
+    for (auto& o : owner) {
+        o.store(0);
+    }
+    std::atomic<bool> shared{false};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 16; ++t) {
+        threads.emplace_back([&]() {
+            std::vector<PageFrameId> held;
+            for (int i = 0; i < 2000; ++i) {
+                if (held.size() < 4) {
+                    if (auto page = manager->allocate_page()) {
+                        if (owner[page.value()].fetch_add(1) != 0) {
+                            shared = true;
+                        }
+                        held.push_back(page.value());
+                    }
+                } else {
+                    for (auto id : held) {
+                        owner[id].fetch_sub(1);
+                        manager->free_page(id);
+                    }
+                    held.clear();
+                }
+            }
+            for (auto id : held) {
+                owner[id].fetch_sub(1);
+                manager->free_page(id);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_FALSE(shared);
+    EXPECT_DOUBLE_EQ(manager->get_memory_usage(), 0.0);
+}
+
+// Test NumaMemoryManager functionality
+TEST(NumaMemoryManagerTest, LocalFirstStaysOnNode) {
+    NumaMemoryManager numa(2, 64, 4);
+    for (int i = 0; i < 20; ++i) {
+        auto page = numa.allocate_page(1);
+        ASSERT_TRUE(page.has_value());
+        EXPECT_EQ(numa.node_of(page.value()), 1u);
+    }
+    NodeStats stats = numa.get_node_stats(1);
+    EXPECT_EQ(stats.local_allocations, 20u);
+    EXPECT_EQ(stats.remote_allocations, 0u);
+    EXPECT_EQ(numa.get_node_stats(0).memory.allocations, 0u);
+}
+
+TEST(NumaMemoryManagerTest, FallbackFollowsDistance) {
+    NumaMemoryManager numa(3, 16, 4);
+    numa.set_distance(0, 2, 12);
+    EXPECT_EQ(numa.fallback_order(0), (std::vector<size_t>{0, 2, 1}));
+    EXPECT_EQ(numa.fallback_order(1), (std::vector<size_t>{1, 0, 2}));
+    EXPECT_THROW(numa.set_distance(0, 3, 10), std::out_of_range);
+}
+
+TEST(NumaMemoryManagerTest, FullNodeFallsBackToRemote) {
+    NumaMemoryManager numa(2, 32, 4);
+    size_t allocated = 0;
+    for (int i = 0; i < 200; ++i) {
+        allocated += numa.allocate_page(0).has_value();
+    }
+    NodeStats local = numa.get_node_stats(0);
+    EXPECT_EQ(local.local_allocations + local.remote_allocations, allocated);
+    EXPECT_EQ(local.failed_allocations, 200u - allocated);
+    EXPECT_GE(local.local_allocations, 32u);
+    EXPECT_EQ(numa.get_node_stats(1).foreign_allocations, local.remote_allocations);
+}
+
+TEST(NumaMemoryManagerTest, InterleaveAlternatesNodes) {
+    NumaMemoryManager numa(2, 64, 4, NumaPolicy::Interleave);
+    std::vector<size_t> nodes;
+    for (int i = 0; i < 6; ++i) {
+        auto page = numa.allocate_page(0);
+        ASSERT_TRUE(page.has_value());
+        nodes.push_back(numa.node_of(page.value()));
+    }
+    EXPECT_EQ(nodes, (std::vector<size_t>{0, 1, 0, 1, 0, 1}));
+    EXPECT_EQ(numa.get_node_stats(0).local_allocations, 3u);
+    EXPECT_EQ(numa.get_node_stats(0).remote_allocations, 3u);
+}
+
+TEST(NumaMemoryManagerTest, RemoteAccessCostsDistance) {
+    NumaMemoryManager numa(2, 64, 4);
+    auto local = numa.allocate_page(0);
+    auto remote = numa.allocate_page(1);
+    ASSERT_TRUE(local.has_value() && remote.has_value());
+
+    numa.access_page(local.value(), 0);
+    numa.access_page(remote.value(), 0);
+    numa.access_page(remote.value(), 0);
+
+    NodeStats stats = numa.get_node_stats(0);
+    EXPECT_EQ(stats.local_accesses, 1u);
+    EXPECT_EQ(stats.remote_accesses, 2u);
+    EXPECT_EQ(stats.access_cost, NumaMemoryManager::LOCAL_DISTANCE + 2 * NumaMemoryManager::REMOTE_DISTANCE);
+
+    double usage_before = numa.get_node_stats(1).memory_usage;
+    numa.free_page(remote.value());
+    EXPECT_LT(numa.get_node_stats(1).memory_usage, usage_before);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -1,25 +1,44 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 22:01:58
+@LastEditTime: 2025-11-18 21:47:30
 @Description: MGLRU Memory Manager Implementation
 @Language: C++17
 */
 
 #include "memory_manager.h"
 #include <algorithm>
+#include <chrono>
+
+namespace {
+
+// threads are spread over the per-thread caches round-robin
+std::atomic<size_t> next_pcp_slot{0};
+thread_local const size_t pcp_slot = next_pcp_slot.fetch_add(1, std::memory_order_relaxed);
+
+} // namespace
 
 MemoryManager::MemoryManager(size_t capacity, size_t num_generations)
     : capacity_(capacity),
       high_watermark_(capacity * 90 / 100),  // 90% capacity
       min_watermark_(capacity * 70 / 100),   // 70% capacity
-      mglru_(num_generations, 64) {
+      mglru_(num_generations, capacity),
+      free_frames_(capacity),
+      free_pages_(capacity),
+      frame_allocated_(new std::atomic<uint8_t>[capacity]),
+      frame_epoch_(new std::atomic<uint32_t>[capacity]),
+      frame_keys_(capacity, NO_KEY),
+      shadow_table_(capacity * 2),           // remember about twice the pool
+      pid_(0.5, 0.1, 0.2) {
     
-    // Initialize physical frame pool
-    physical_frames_list_.reserve(capacity);
+    // Initialize physical frame pool, pushed in reverse so frame 0 pops first
     for (size_t i = 0; i < capacity; ++i) {
-        physical_frames_list_.push_back(i);
-        free_list_.push_back(i);
+        frame_allocated_[i].store(0, std::memory_order_relaxed);
+        frame_epoch_[i].store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = capacity; i > 0; --i) {
+        free_frames_.push(i - 1);
     }
+    stats_.refault_distance_histogram.assign(num_generations + 1, 0);
     
     // Start background reclaim thread
     reclaim_thread_ = std::thread(&MemoryManager::reclaimed_loop, this);
@@ -38,89 +57,306 @@ MemoryManager::~MemoryManager() {
     }
 }
 
-std::optional<PageFrameId> MemoryManager::allocate_page() {
-    std::unique_lock<std::mutex> lock(mtx_);
-    
+std::optional<PageFrameId> MemoryManager::allocate_page(PageClass page_class) {
+    return allocate(NO_KEY, page_class, true);
+}
+
+std::optional<PageFrameId> MemoryManager::allocate_page(PageKey key, PageClass page_class) {
+    return allocate(key, page_class, true);
+}
+
+std::optional<PageFrameId> MemoryManager::try_allocate_page(PageKey key, PageClass page_class) {
+    return allocate(key, page_class, false);
+}
+
+MemoryManager::PcpCache* MemoryManager::lock_pcp() {
+    PcpCache* pcp = &pcp_[pcp_slot % PCP_SLOTS];
+    if (pcp->busy.test_and_set(std::memory_order_acquire)) {
+        return nullptr;  // shared slot in use, go straight to the global pool
+    }
+    return pcp;
+}
+
+std::optional<PageFrameId> MemoryManager::take_free_frame(PcpCache* pcp) {
+    PageFrameId page_id;
+    if (pcp != nullptr) {
+        if (pcp->count == 0) {
+            pcp->count = free_frames_.pop_batch(pcp->pages.data(), PCP_BATCH);
+        }
+        if (pcp->count == 0) {
+            return std::nullopt;
+        }
+        page_id = pcp->pages[--pcp->count];
+    } else if (free_frames_.pop_batch(&page_id, 1) == 0) {
+        return std::nullopt;
+    }
+    free_pages_.fetch_sub(1, std::memory_order_relaxed);
+    return page_id;
+}
+
+void MemoryManager::put_free_frame(PageFrameId page_id) {
+    free_pages_.fetch_add(1, std::memory_order_relaxed);
+    PcpCache* pcp = lock_pcp();
+    if (pcp == nullptr) {
+        free_frames_.push(page_id);
+        return;
+    }
+    pcp->pages[pcp->count++] = page_id;
+    if (pcp->count > PCP_HIGH) {
+        // give the coldest batch back so other threads can use it
+        free_frames_.push_batch(pcp->pages.data(), PCP_BATCH);
+        std::copy(pcp->pages.begin() + PCP_BATCH, pcp->pages.begin() + pcp->count, pcp->pages.begin());
+        pcp->count -= PCP_BATCH;
+    }
+    unlock_pcp(pcp);
+}
+
+std::optional<PageFrameId> MemoryManager::allocate(PageKey key, PageClass page_class, bool allow_reclaim) {
+    // Fast path: no lock and no allocation, a frame from this thread's cache
+    PcpCache* pcp = lock_pcp();
+    std::optional<PageFrameId> page = take_free_frame(pcp);
+    if (!page) {
+        if (pcp != nullptr) {
+            unlock_pcp(pcp);
+        }
+        return allocate_slow(key, page_class, allow_reclaim);
+    }
+
+    const PageFrameId page_id = *page;
+    const uint32_t epoch = mark_allocated(page_id);
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+
+    if (key == NO_KEY && pcp != nullptr) {
+        // Anonymous page: queue the MGLRU insertion, take the lock once per batch
+        pcp->lru_add[pcp->pending] = page_id;
+        pcp->lru_class[pcp->pending] = page_class;
+        pcp->lru_epoch[pcp->pending] = epoch;
+        if (++pcp->pending == LRU_ADD_BATCH) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            flush_lru_batch(*pcp);
+        }
+        unlock_pcp(pcp);
+    } else {
+        // Keyed pages need the shadow lookup right away
+        if (pcp != nullptr) {
+            unlock_pcp(pcp);
+        }
+        std::lock_guard<std::mutex> lock(mtx_);
+        install_page(page_id, key, page_class);
+    }
+
+    wake_kswapd_if_needed();
+    return page_id;
+}
+
+std::optional<PageFrameId> MemoryManager::allocate_slow(PageKey key, PageClass page_class, bool allow_reclaim) {
+    std::optional<PageFrameId> page;
+    {
+        // frames may be stranded in other threads' caches
+        std::lock_guard<std::mutex> lock(mtx_);
+        drain_free_caches();
+        page = take_free_frame(nullptr);
+    }
+
+    if (!page && !allow_reclaim) {
+        cv_.notify_one();  // let kswapd catch up for the next caller
+        return std::nullopt;
+    }
+
     // If no free pages, try direct reclaim
-    if (free_list_.empty()) {
-        lock.unlock();
+    if (!page) {
         direct_reclaim(10);  // Try to reclaim 10 pages
-        lock.lock();
-        
-        if (free_list_.empty()) {
+        page = take_free_frame(nullptr);
+        if (!page) {
             return std::nullopt;  // OOM
         }
     }
-    
-    // Allocate from free list
-    PageFrameId page_id = free_list_.front();
-    free_list_.pop_front();
-    
+
+    mark_allocated(*page);
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        install_page(*page, key, page_class);
+    }
+    wake_kswapd_if_needed();
+    return page;
+}
+
+void MemoryManager::install_page(PageFrameId page_id, PageKey key, PageClass page_class) {
     // Add to MGLRU (it will manage the metadata internally)
-    mglru_.on_page_added(page_id);
-    
+    mglru_.on_page_added(page_id, page_class);
+
+    if (key == NO_KEY) {
+        return;
+    }
+    frame_keys_[page_id] = key;
+
+    // Refault: the key was evicted before. The distance is the number of
+    // generations aged out since, seq stamps are truncated.
+    if (auto shadow = shadow_table_.lookup_and_erase(key)) {
+        uint64_t distance = ShadowTable::seq_distance(mglru_.get_min_seq(), shadow->seq);
+        ++stats_.refaults;
+        auto& histogram = stats_.refault_distance_histogram;
+        ++histogram[std::min<size_t>(distance, histogram.size() - 1)];
+
+        if (distance < mglru_.num_generations()) {
+            // still in the working set: reclaim was too eager, and the
+            // page should not be the first candidate again
+            ++stats_.workingset_refaults;
+            ++stats_.refaults_by_class[class_index(shadow->page_class)];
+            ++period_refaults_;
+            // charged to the class and tier the page was evicted from
+            mglru_.on_refault(shadow->page_class, shadow->tier);
+            mglru_.record_access(page_id);
+        }
+    }
+}
+
+uint32_t MemoryManager::mark_allocated(PageFrameId page_id) {
+    // the epoch moves first: whoever sees the frame allocated sees its epoch
+    uint32_t epoch = frame_epoch_[page_id].fetch_add(1, std::memory_order_relaxed) + 1;
+    frame_allocated_[page_id].store(1, std::memory_order_release);
+    return epoch;
+}
+
+void MemoryManager::flush_lru_batch(PcpCache& pcp) {
+    for (size_t i = 0; i < pcp.pending; ++i) {
+        // skip frames freed while they were queued, and frames freed and
+        // allocated again: the new owner inserts the page itself
+        PageFrameId page_id = pcp.lru_add[i];
+        if (frame_allocated_[page_id].load(std::memory_order_acquire) &&
+            frame_epoch_[page_id].load(std::memory_order_relaxed) == pcp.lru_epoch[i]) {
+            mglru_.on_page_added(page_id, pcp.lru_class[i]);
+        }
+    }
+    pcp.pending = 0;
+}
+
+void MemoryManager::drain_lru_batches() {
+    for (auto& pcp : pcp_) {
+        if (!pcp.busy.test_and_set(std::memory_order_acquire)) {
+            flush_lru_batch(pcp);
+            unlock_pcp(&pcp);
+        }
+    }
+}
+
+void MemoryManager::drain_free_caches() {
+    for (auto& pcp : pcp_) {
+        if (!pcp.busy.test_and_set(std::memory_order_acquire)) {
+            free_frames_.push_batch(pcp.pages.data(), pcp.count);
+            pcp.count = 0;
+            flush_lru_batch(pcp);
+            unlock_pcp(&pcp);
+        }
+    }
+}
+
+void MemoryManager::wake_kswapd_if_needed() {
     // Wake up background reclaim if above high watermark
-    size_t used = capacity_ - free_list_.size();
+    size_t used = capacity_ - free_pages_.load(std::memory_order_relaxed);
     if (used > high_watermark_) {
         cv_.notify_one();
     }
-    
-    return page_id;
 }
 
 void MemoryManager::access_page(PageFrameId page_id) {
-    std::lock_guard<std::mutex> lock(mtx_);
-    
-    // Mark as accessed in MGLRU
-    // MGLRU will check internally if page exists
-    mglru_.on_page_accessed(page_id);
+    // No lock: the page table is sized to capacity_ up front, so the bitmap
+    // never reallocates and the atomic bit set is all that is needed.
+    // Frames outside the pool are ignored by the tracker.
+    mglru_.record_access(page_id);
+}
+
+void MemoryManager::access_pages(const PageFrameId* page_ids, size_t count) {
+    mglru_.record_accesses(page_ids, count);
 }
 
 void MemoryManager::free_page(PageFrameId page_id) {
-    std::lock_guard<std::mutex> lock(mtx_);
-    
-    // For explicit free, we need to get metadata from MGLRU
-    // For now, just add back to free list
-    // MGLRU will handle removal during reclaim
-    add_to_free_list(page_id);
+    if (page_id >= capacity_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        // ignore double frees, the frame may already be back in a free pool
+        if (!frame_allocated_[page_id].load(std::memory_order_acquire)) {
+            return;
+        }
+        
+        // Stop tracking the frame so reclaim cannot hand it out a second time;
+        // an explicit free is not an eviction and leaves no shadow entry
+        mglru_.on_page_removed(page_id);
+        frame_keys_[page_id] = NO_KEY;
+        frame_allocated_[page_id].store(0, std::memory_order_release);
+    }
+    put_free_frame(page_id);
 }
 
 double MemoryManager::get_memory_usage() const {
-    std::lock_guard<std::mutex> lock(mtx_);
-    size_t used = capacity_ - free_list_.size();
+    size_t used = capacity_ - free_pages_.load(std::memory_order_relaxed);
     return static_cast<double>(used) / static_cast<double>(capacity_);
 }
 
+MemoryStats MemoryManager::get_stats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    MemoryStats stats = stats_;
+    stats.allocations = allocations_.load(std::memory_order_relaxed);
+    return stats;
+}
+
 void MemoryManager::reclaimed_loop() {
     while (true) {
         std::unique_lock<std::mutex> lock(mtx_);
         
-        // Wait until we need to reclaim or thread is stopped
-        cv_.wait(lock, [this] {
-            size_t used = capacity_ - free_list_.size();
-            return stop_thread_ || used > high_watermark_;
+        // Wait until we need to reclaim, an allocation stalled, or thread is stopped.
+        // Lock-free allocations notify without mtx_, so a wakeup can slip
+        // between the check and the wait; the timeout bounds that delay.
+        bool woken = cv_.wait_for(lock, std::chrono::milliseconds(10), [this] {
+            size_t used = capacity_ - free_pages_.load(std::memory_order_relaxed);
+            return stop_thread_ || used > high_watermark_ || period_stalls_ > 0;
         });
         
         if (stop_thread_) {
             break;
         }
+        if (!woken) {
+            // idle: keep generations ticking so their birth times track
+            // recency for working-set estimation
+            if (aging_interval_.count() > 0 &&
+                mglru_.now() - mglru_.youngest_birth() >= aging_interval_) {
+                drain_lru_batches();
+                mglru_.age();
+            }
+            continue;
+        }
         
-        // Reclaim pages until below min watermark
-        size_t used = capacity_ - free_list_.size();
+        // One reclaim period: scan the budget chosen by the controller, but
+        // never so much that usage could drop below the min watermark
+        size_t used = capacity_ - free_pages_.load(std::memory_order_relaxed);
+        size_t scanned = 0;
+        size_t reclaimed = 0;
         if (used > min_watermark_) {
-            size_t target_reclaim = used - min_watermark_;
-            
-            // Unlock while scanning to avoid holding lock too long
-            lock.unlock();
-            
-            // Scan and reclaim pages
-            ReclaimResult result = mglru_.scan_and_reclaim(target_reclaim);
+            size_t budget = std::min(pid_.get_scan_intensity(), used - min_watermark_);
             
-            // Relock and add evicted pages to free list
-            lock.lock();
-            for (auto page_id : result.evicted_pages) {
-                add_to_free_list(page_id);
-            }
+            // The scan relinks the generation lists, so it runs under the lock;
+            // accesses keep flowing meanwhile since they only touch the bitmap.
+            // Queued new pages are inserted first so they can be reclaimed too.
+            drain_lru_batches();
+            ReclaimResult result = mglru_.scan_and_reclaim(budget);
+            release_evicted(result);
+            scanned = result.scanned_pages_count;
+            reclaimed = result.evicted_pages.size();
+        }
+
+        pid_.update_metrics(period_refaults_, scanned, reclaimed, period_stalls_);
+        period_refaults_ = 0;
+        period_stalls_ = 0;
+        stats_.kswapd_scanned_pages += scanned;
+        stats_.kswapd_reclaimed_pages += reclaimed;
+
+        // nothing reclaimable right now (everything hot or just aged),
+        // back off briefly instead of spinning on the lock
+        if (reclaimed == 0) {
+            cv_.wait_for(lock, std::chrono::milliseconds(1), [this] { return stop_thread_; });
         }
     }
 }
@@ -129,17 +365,85 @@ size_t MemoryManager::direct_reclaim(size_t pages_to_reclaim) {
     std::lock_guard<std::mutex> lock(mtx_);
     
     // Scan and reclaim
+    drain_lru_batches();
     ReclaimResult result = mglru_.scan_and_reclaim(pages_to_reclaim);
     
-    // Add evicted pages to free list
-    for (auto page_id : result.evicted_pages) {
-        add_to_free_list(page_id);
-    }
+    // Add evicted pages to the free pool
+    release_evicted(result);
+
+    // kswapd fell behind: report the stall so the next period scans more
+    ++stats_.direct_reclaims;
+    stats_.direct_reclaimed_pages += result.evicted_pages.size();
+    period_stalls_ += std::max<size_t>(result.evicted_pages.size(), 1);
+    cv_.notify_one();
     
     return result.evicted_pages.size();
 }
 
-void MemoryManager::add_to_free_list(PageFrameId page_id) {
-    free_list_.push_back(page_id);
+void MemoryManager::release_evicted(const ReclaimResult& result) {
+    stats_.evictions_by_class[class_index(result.evicted_class)] += result.evicted_pages.size();
+    for (size_t i = 0; i < result.evicted_pages.size(); ++i) {
+        PageFrameId page_id = result.evicted_pages[i];
+        PageKey& key = frame_keys_[page_id];
+        if (key != NO_KEY) {
+            shadow_table_.insert(key, result.evicted_seq, result.evicted_class, result.evicted_tiers[i]);
+            key = NO_KEY;
+        }
+        frame_allocated_[page_id].store(0, std::memory_order_release);
+    }
+    // one CAS for the whole batch
+    free_frames_.push_batch(result.evicted_pages.data(), result.evicted_pages.size());
+    free_pages_.fetch_add(result.evicted_pages.size(), std::memory_order_relaxed);
+}
+
+std::vector<WorkingSetEstimate> MemoryManager::estimate_working_set(const std::vector<std::chrono::milliseconds>& windows) const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::vector<WorkingSetEstimate> estimates;
+    estimates.reserve(windows.size());
+    for (auto window : windows) {
+        size_t pages = mglru_.working_set_pages(window);
+        estimates.push_back({window, pages, pages * PAGE_SIZE});
+    }
+    return estimates;
+}
+
+WorkingSetEstimate MemoryManager::estimate_working_set(std::chrono::milliseconds window) const {
+    return estimate_working_set(std::vector<std::chrono::milliseconds>{window}).front();
 }
 
+size_t MemoryManager::proactive_reclaim(size_t target_bytes) {
+    const size_t target_pages = (target_bytes + PAGE_SIZE - 1) / PAGE_SIZE;
+    std::lock_guard<std::mutex> lock(mtx_);
+    drain_lru_batches();
+
+    // Rounds that only age an empty oldest generation move on; a round that
+    // scanned pages but evicted none found the cold end referenced, i.e. the
+    // rest is working set, so stop there rather than age it out.
+    size_t reclaimed = 0;
+    size_t idle_rounds = 0;
+    while (reclaimed < target_pages && mglru_.size() > 0 && idle_rounds <= mglru_.num_generations()) {
+        ReclaimResult result = mglru_.scan_and_reclaim(target_pages - reclaimed);
+        release_evicted(result);
+        if (result.evicted_pages.empty()) {
+            if (result.scanned_pages_count > 0) {
+                break;
+            }
+            ++idle_rounds;
+            continue;
+        }
+        idle_rounds = 0;
+        reclaimed += result.evicted_pages.size();
+    }
+    stats_.proactive_reclaimed_pages += reclaimed;
+    return reclaimed * PAGE_SIZE;
+}
+
+void MemoryManager::set_aging_interval(std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    aging_interval_ = interval;
+}
+
+void MemoryManager::set_clock(std::function<MglruClock::time_point()> clock) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    mglru_.set_clock(std::move(clock));
+}
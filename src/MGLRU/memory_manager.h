@@ -1,6 +1,6 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:58:12
+@LastEditTime: 2025-11-14 21:40:52
 @Description: MGLRU Memory Manager Implementation
 @Language: C++17
 */
@@ -9,16 +9,47 @@
 #define MEMORY_MANAGER_H
 
 #include "mglru_core.h"
+#include "pid_controller.h"
+#include "shadow_table.h"
+#include "free_frame_stack.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <vector>
-#include <list>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
+#include <functional>
 #include <optional>
 #include <unordered_map>
 
+struct MemoryStats {
+    size_t allocations = 0;
+    // re-allocations of an evicted key whose shadow entry survived
+    size_t refaults = 0;
+    // refaults within num_generations agings of the eviction, i.e. pages
+    // that were still part of the working set; these feed the controller
+    size_t workingset_refaults = 0;
+    // the same split by page class
+    std::array<size_t, NUM_PAGE_CLASSES> refaults_by_class{};
+    std::array<size_t, NUM_PAGE_CLASSES> evictions_by_class{};
+    // refaults by distance in generations, the last bucket collects the rest
+    std::vector<size_t> refault_distance_histogram;
+    size_t direct_reclaims = 0;
+    size_t direct_reclaimed_pages = 0;
+    size_t kswapd_scanned_pages = 0;
+    size_t kswapd_reclaimed_pages = 0;
+    size_t proactive_reclaimed_pages = 0;
+};
+
+struct WorkingSetEstimate {
+    std::chrono::milliseconds window;
+    size_t pages;
+    size_t bytes;
+};
+
 class MemoryManager {
 public:
     MemoryManager(size_t capacity, size_t num_generations);
@@ -26,17 +57,94 @@ public:
 
     // emulate the physical page frame allocation
     // may be blocked if it's full
-    std::optional<PageFrameId> allocate_page();
+    // page_class tells reclaim which lists and refault feedback the page uses
+    std::optional<PageFrameId> allocate_page(PageClass page_class = PageClass::Anon);
+
+    // allocate a frame for the data identified by `key`; if the same key was
+    // evicted recently the allocation is a refault and the page starts hot
+    std::optional<PageFrameId> allocate_page(PageKey key, PageClass page_class = PageClass::Anon);
+
+    // fast path only: take a free frame if there is one, never reclaim;
+    // lets a caller try other pools before stalling in direct reclaim
+    std::optional<PageFrameId> try_allocate_page(PageKey key = NO_KEY, PageClass page_class = PageClass::Anon);
+
+    static constexpr PageKey NO_KEY = UINT64_MAX;
 
     // emulate the physical page frame access
+    // lock-free: only the accessed bit is set, like the MMU setting the PTE
+    // accessed bit; the page moves between generations at the next scan
     void access_page(PageFrameId page_id);
 
+    // batched access_page for trace replay
+    void access_pages(const PageFrameId* page_ids, size_t count);
+
     // emulate the physical page frame free
     void free_page(PageFrameId page_id);
 
     double get_memory_usage() const;
 
+    MemoryStats get_stats() const;
+
+    // Working-set size per window: pages in generations born within the
+    // window, i.e. added or found referenced since. Meaningful once
+    // generations age over time, see set_aging_interval.
+    std::vector<WorkingSetEstimate> estimate_working_set(const std::vector<std::chrono::milliseconds>& windows) const;
+    WorkingSetEstimate estimate_working_set(std::chrono::milliseconds window) const;
+
+    // Evict up to target_bytes of cold pages ahead of pressure, oldest
+    // generations first, like writing to memory.reclaim. Returns the bytes
+    // reclaimed, less than asked when the rest is hot.
+    size_t proactive_reclaim(size_t target_bytes);
+
+    // let kswapd open a new generation whenever the youngest is older than
+    // `interval`, even without pressure; zero (the default) disables it
+    void set_aging_interval(std::chrono::milliseconds interval);
+
+    // swap the MGLRU clock, e.g. for a simulated timeline
+    void set_clock(std::function<MglruClock::time_point()> clock);
+
 private:
+    // per-thread page cache (the kernel's per-cpu pages): a private stack of
+    // free frames refilled/drained from the global pool in batches, plus a
+    // batch of new pages waiting to be inserted into MGLRU under mtx_
+    static constexpr size_t PCP_SLOTS = 16;
+    static constexpr size_t PCP_HIGH = 64;       // drain when the cache grows past this
+    static constexpr size_t PCP_BATCH = 16;      // frames moved per refill / drain
+    static constexpr size_t LRU_ADD_BATCH = 16;  // new pages per MGLRU insertion batch
+
+    struct alignas(64) PcpCache {
+        std::atomic_flag busy = ATOMIC_FLAG_INIT;  // owned by one thread at a time
+        size_t count = 0;
+        std::array<PageFrameId, PCP_HIGH + 1> pages;
+        size_t pending = 0;
+        std::array<PageFrameId, LRU_ADD_BATCH> lru_add;
+        std::array<PageClass, LRU_ADD_BATCH> lru_class;
+        std::array<uint32_t, LRU_ADD_BATCH> lru_epoch;
+    };
+
+    std::optional<PageFrameId> allocate(PageKey key, PageClass page_class, bool allow_reclaim);
+    std::optional<PageFrameId> allocate_slow(PageKey key, PageClass page_class, bool allow_reclaim);
+
+    // the calling thread's cache, nullptr if another thread holds it
+    PcpCache* lock_pcp();
+    static void unlock_pcp(PcpCache* pcp) { pcp->busy.clear(std::memory_order_release); }
+
+    std::optional<PageFrameId> take_free_frame(PcpCache* pcp);
+    void put_free_frame(PageFrameId page_id);
+
+    // hand a newly allocated frame to MGLRU and check for a refault;
+    // caller holds mtx_
+    void install_page(PageFrameId page_id, PageKey key, PageClass page_class);
+
+    // flag a frame as handed out and start its next allocation epoch
+    uint32_t mark_allocated(PageFrameId page_id);
+
+    // caller holds mtx_; caches owned by another thread right now are skipped
+    void flush_lru_batch(PcpCache& pcp);
+    void drain_lru_batches();
+    void drain_free_caches();
+
+    void wake_kswapd_if_needed();
 
     // async reclaimed loop(emulate kswapd)
     void reclaimed_loop();
@@ -44,19 +152,43 @@ private:
     // sync reclaimed loop
     size_t direct_reclaim(size_t pages_to_reclaim);
 
-    void add_to_free_list(PageFrameId page_id);
+    // return evicted frames to the free pool and leave shadow entries
+    // for their keys; caller holds mtx_
+    void release_evicted(const ReclaimResult& result);
 
     const size_t capacity_;
     const size_t high_watermark_;
     const size_t min_watermark_;
 
+    // guards the MGLRU lists, shadow entries and stats; neither the access
+    // path nor the allocation fast path takes it
     mutable std::mutex mtx_;  // mutable for const member functions
     MGLRU mglru_;
 
-    // emulate the physical page frame pool
-    std::vector<PageFrameId> physical_frames_list_;
-    // track all free pages
-    std::list<PageFrameId> free_list_;
+    // global pool of free frames, lock-free
+    FreeFrameStack free_frames_;
+    // free frames in the global pool and in all per-thread caches
+    std::atomic<size_t> free_pages_;
+    std::array<PcpCache, PCP_SLOTS> pcp_;
+    // 1 while the frame is handed out
+    std::unique_ptr<std::atomic<uint8_t>[]> frame_allocated_;
+    // bumped by every allocation of the frame: a page still queued in an LRU
+    // add batch is only inserted if the frame was not freed and handed out
+    // again in between
+    std::unique_ptr<std::atomic<uint32_t>[]> frame_epoch_;
+    std::atomic<size_t> allocations_{0};
+
+    // key currently held by each frame, NO_KEY if anonymous or free
+    std::vector<PageKey> frame_keys_;
+    ShadowTable shadow_table_;
+
+    // sets the kswapd scan budget from the last period's outcome
+    PidController pid_;
+    // events since the last kswapd period
+    size_t period_refaults_ = 0;
+    size_t period_stalls_ = 0;
+    MemoryStats stats_;
+    std::chrono::milliseconds aging_interval_{0};
 
     // background reclaim thread (emulate kswapd)
     std::thread reclaim_thread_;
@@ -1,39 +1,109 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:59:40
+@LastEditTime: 2025-11-15 20:44:12
 @Description: MGLRU Core Implementation
 @Language: C++17
 */
 
 #include "mglru_core.h"
 
-MGLRU::MGLRU(size_t num_generations, size_t tracker_size_per_gen)
-    : pid_controller_(0.1, 0.01, 0.05), max_generations_(num_generations) {
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// a tier needs this many (decayed) refaults before it can be protected
+constexpr uint64_t MIN_PROTECT_REFAULTS = 2;
+
+} // namespace
+
+MGLRU::MGLRU(size_t num_generations, size_t capacity)
+    : max_generations_(num_generations), tracker_(capacity), regions_(capacity),
+      young_regions_(capacity / PageTableRegions::PAGES_PER_REGION) {
+    if (num_generations == 0) {
+        throw std::invalid_argument("MGLRU needs at least one generation");
+    }
+    if (capacity >= INVALID_PAGE) {
+        throw std::invalid_argument("MGLRU capacity exceeds 32-bit page index range");
+    }
     
-    // Initialize generations (from youngest to oldest)
-    for (size_t i = 0; i < num_generations; ++i) {
-        generations_.emplace_back(i, tracker_size_per_gen);
+    // Initialize the generation ring; all slots start empty with
+    // min_seq = 0 (oldest) and max_seq = num_generations - 1 (youngest)
+    for (size_t i = 0; i < num_generations * NUM_PAGE_CLASSES; ++i) {
+        generations_.emplace_back(i / NUM_PAGE_CLASSES);
     }
+    min_seq_ = 0;
+    max_seq_ = num_generations - 1;
+
+    clock_ = [] { return MglruClock::now(); };
+    const MglruClock::time_point birth = clock_();
+    for (auto& gen : generations_) {
+        gen.set_birth(birth);
+    }
+
+    page_table_.resize(capacity);
 }
 
-void MGLRU::on_page_added(PageFrameId page_id) {
-    // New page starts at the youngest generation (generation 0)
-    auto it = generations_[0].add_page(page_id);
-    
-    PageMetadata metadata;
-    metadata.id = page_id;
-    metadata.generation_index = 0;
-    metadata.lru_iterator = it;
-    
-    page_table_[page_id] = metadata;
+void MGLRU::ensure_capacity(PageFrameId page_id) {
+    if (page_id >= INVALID_PAGE) {
+        throw std::out_of_range("page frame id exceeds 32-bit page index range");
+    }
+    if (page_id >= page_table_.size()) {
+        // grow geometrically, the tracker is reallocated on every resize
+        size_t new_size = std::max<size_t>(page_id + 1, page_table_.size() * 2);
+        new_size = std::min<size_t>(new_size, INVALID_PAGE);
+        page_table_.resize(new_size);
+        tracker_.resize(new_size);
+        regions_.resize(new_size);
+    }
+}
+
+void MGLRU::on_page_added(PageFrameId page_id, PageClass page_class) {
+    ensure_capacity(page_id);
+
+    // A frame re-added without being removed first must not leave a stale node behind
+    PageMetadata& meta = page_table_[page_id];
+    if (meta.present) {
+        generation_of(effective_seq(meta), meta.page_class).remove_page(page_table_, page_id);
+        --class_count_[class_index(meta.page_class)];
+    } else {
+        meta.present = true;
+        ++page_count_;
+        regions_.map(page_id);
+    }
+
+    // New page starts at the youngest generation. Its accessed bit is kept:
+    // the page may have been touched while its insertion was batched.
+    meta.seq = max_seq_;
+    meta.page_class = page_class;
+    meta.refs = 0;
+    ++class_count_[class_index(page_class)];
+    generation_of(max_seq_, page_class).add_page(page_table_, page_id);
 }
 
 void MGLRU::on_page_accessed(PageFrameId page_id) {
-    // Mark the page as accessed in its generation's tracker
-    auto it = page_table_.find(page_id);
-    if (it != page_table_.end()) {
-        size_t gen_idx = it->second.generation_index;
-        generations_[gen_idx].get_tracker().set(page_id);
+    // Mark the page as accessed, the list move is deferred to the next scan
+    if (is_tracked(page_id)) {
+        tracker_.set(page_id);
+    }
+}
+
+void MGLRU::record_accesses(const PageFrameId* page_ids, size_t count) {
+    // coalesce runs of frames in the same word into a single fetch_or
+    constexpr PageFrameId word_mask = AccessTracker::PAGES_PER_WORD - 1;
+    PageFrameId base = 0;
+    uint64_t bits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const PageFrameId word_base = page_ids[i] & ~word_mask;
+        if (bits != 0 && word_base != base) {
+            tracker_.set_range(base, bits);
+            bits = 0;
+        }
+        base = word_base;
+        bits |= 1ULL << (page_ids[i] & word_mask);
+    }
+    if (bits != 0) {
+        tracker_.set_range(base, bits);
     }
 }
 
@@ -41,128 +111,304 @@ ReclaimResult MGLRU::scan_and_reclaim(size_t pages_to_scan) {
     ReclaimResult result;
     result.promoted_pages_count = 0;
     result.scanned_pages_count = 0;
+    result.protected_pages_count = 0;
+    result.evicted_seq = min_seq_;
     
-    // Start scanning from the oldest generation
-    size_t oldest_gen_idx = max_generations_ - 1;
-    auto& oldest_gen = generations_[oldest_gen_idx];
-    auto& pages = oldest_gen.get_pages();
+    // Start scanning from the oldest generation of the cheaper class
+    const PageClass page_class = pick_class_to_scan();
+    result.evicted_class = page_class;
+    auto& oldest_gen = generation_of(min_seq_, page_class);
     
-    if (pages.empty()) {
+    if (oldest_gen.empty()) {
         // No pages in oldest generation, age them
         age_generations();
         return result;
     }
     
-    // Collect pages to scan first (to avoid iterator invalidation)
-    std::vector<PageFrameId> pages_to_process;
+    // Walk from the tail towards the head. Every scanned page leaves the
+    // oldest generation, so the next candidate is the new tail; with a single
+    // generation promotion is a no-op and the walk follows the prev link.
     size_t scanned = 0;
-    
-    for (auto rit = pages.rbegin(); rit != pages.rend() && scanned < pages_to_scan; ++rit) {
-        pages_to_process.push_back(*rit);
+    PageIndex cur = oldest_gen.tail();
+    while (cur != INVALID_PAGE && scanned < pages_to_scan) {
+        const PageIndex prev = page_table_[cur].prev;
         ++scanned;
-    }
-    
-    // Process each page
-    for (auto page_id : pages_to_process) {
-        auto meta_it = page_table_.find(page_id);
-        if (meta_it == page_table_.end()) {
-            continue;
-        }
         
-        PageMetadata& meta = meta_it->second;
+        PageMetadata& meta = page_table_[cur];
         
         // Check if page was accessed
-        if (oldest_gen.get_tracker().check_and_clear(page_id)) {
-            // Page was accessed, promote it
-            promote_page(meta);
-            result.promoted_pages_count++;
+        if (tracker_.check_and_clear(cur)) {
+            // Page was accessed, promote it and its hot neighbours
+            if (meta.refs < UINT8_MAX) {
+                ++meta.refs;
+            }
+            promote_page(cur);
+            result.promoted_pages_count += 1 + look_around(cur);
+        } else if (is_protected(meta)) {
+            // Unreferenced, but its tier has been refaulting: give it another round
+            promote_page(cur);
+            result.protected_pages_count++;
         } else {
             // Page was not accessed, evict it
-            oldest_gen.remove_page(meta.lru_iterator);
-            page_table_.erase(meta_it);
-            result.evicted_pages.push_back(page_id);
+            const uint8_t tier = tier_of(meta.refs);
+            oldest_gen.remove_page(page_table_, cur);
+            meta.present = false;
+            --page_count_;
+            --class_count_[class_index(page_class)];
+            regions_.unmap(cur);
+            tier_stats_[class_index(page_class)][tier].evicted++;
+            result.evicted_pages.push_back(cur);
+            result.evicted_tiers.push_back(tier);
         }
+        cur = max_generations_ == 1 ? prev : oldest_gen.tail();
     }
     
     result.scanned_pages_count = scanned;
     
     // Age generations if oldest generation is getting small
-    if (pages.size() < pages_to_scan / 4) {
+    if (oldest_size() < pages_to_scan / 4) {
         age_generations();
     }
     
     return result;
 }
 
-void MGLRU::on_page_removed(const PageMetadata& page_meta) {
-    // Remove page from its generation
-    size_t gen_idx = page_meta.generation_index;
-    generations_[gen_idx].remove_page(page_meta.lru_iterator);
-    
-    // Remove from page table
-    page_table_.erase(page_meta.id);
+void MGLRU::on_page_removed(PageFrameId page_id) {
+    if (!is_tracked(page_id)) {
+        return;
+    }
+    PageMetadata& meta = page_table_[page_id];
+    generation_of(effective_seq(meta), meta.page_class).remove_page(page_table_, page_id);
+    meta.present = false;
+    --page_count_;
+    --class_count_[class_index(meta.page_class)];
+    regions_.unmap(page_id);
+    // the next owner of the frame starts unreferenced
+    tracker_.check_and_clear(page_id);
+}
+
+void MGLRU::on_refault(PageClass page_class, uint8_t tier) {
+    tier_stats_[class_index(page_class)][std::min<size_t>(tier, NUM_TIERS - 1)].refaulted++;
+}
+
+double MGLRU::refault_rate(PageClass page_class, size_t tier) const {
+    const TierStats& stats = tier_stats_[class_index(page_class)][tier];
+    return static_cast<double>(stats.refaulted) / static_cast<double>(std::max<uint64_t>(stats.evicted, 1));
+}
+
+double MGLRU::refault_rate(PageClass page_class) const {
+    uint64_t evicted = 0;
+    uint64_t refaulted = 0;
+    for (const TierStats& stats : tier_stats_[class_index(page_class)]) {
+        evicted += stats.evicted;
+        refaulted += stats.refaulted;
+    }
+    return static_cast<double>(refaulted) / static_cast<double>(std::max<uint64_t>(evicted, 1));
+}
+
+uint8_t MGLRU::tier_of(uint8_t refs) {
+    // floor(log2(refs + 1)): 0 -> 0, 1-2 -> 1, 3-6 -> 2, 7+ -> 3
+    uint8_t tier = 0;
+    for (unsigned v = refs + 1u; v > 1 && tier < NUM_TIERS - 1; v >>= 1) {
+        ++tier;
+    }
+    return tier;
+}
+
+PageClass MGLRU::pick_class_to_scan() {
+    // Prefer the class whose evictions come back less often; on a tie take
+    // the class with more pages in the oldest generation. A class with
+    // nothing to scan is never picked over one that has pages.
+    const PageClass anon = PageClass::Anon;
+    const PageClass file = PageClass::File;
+    const size_t anon_pages = generation_of(min_seq_, anon).size();
+    const size_t file_pages = generation_of(min_seq_, file).size();
+    if (anon_pages == 0 || file_pages == 0) {
+        return file_pages > 0 ? file : anon;
+    }
+
+    const double anon_rate = refault_rate(anon);
+    const double file_rate = refault_rate(file);
+    if (anon_rate != file_rate) {
+        return anon_rate < file_rate ? anon : file;
+    }
+    return file_pages >= anon_pages ? file : anon;
+}
+
+bool MGLRU::is_protected(const PageMetadata& page_meta) const {
+    const size_t tier = tier_of(page_meta.refs);
+    if (tier == 0) {
+        return false;
+    }
+    const TierStats& stats = tier_stats_[class_index(page_meta.page_class)][tier];
+    return stats.refaulted >= MIN_PROTECT_REFAULTS &&
+           refault_rate(page_meta.page_class, tier) > refault_rate(page_meta.page_class, 0);
 }
 
 void MGLRU::age_generations() {
-    // Move all pages from younger generations to older generations
-    // This simulates time passing
-    
-    // Start from the oldest generation
-    size_t oldest_idx = max_generations_ - 1;
-    
-    // Age from second oldest to youngest
-    for (int i = oldest_idx; i >= 1; --i) {
-        auto& younger_gen = generations_[i - 1];
-        auto& older_gen = generations_[i];
-        auto& younger_pages = younger_gen.get_pages();
-        
-        // Collect pages first to avoid issues
-        std::vector<PageFrameId> pages_to_move;
-        for (auto page_id : younger_pages) {
-            pages_to_move.push_back(page_id);
+    // This simulates time passing: a new, empty youngest generation is
+    // opened by bumping max_seq. Pages keep their sequence numbers.
+    if (max_generations_ == 1) {
+        return;
+    }
+
+    if (max_seq_ - min_seq_ + 1 == max_generations_) {
+        // The ring is full: splice the oldest generation into the next
+        // oldest. Its pages now have seq < min_seq and are read as min_seq.
+        for (size_t c = 0; c < NUM_PAGE_CLASSES; ++c) {
+            const PageClass page_class = static_cast<PageClass>(c);
+            generation_of(min_seq_ + 1, page_class).absorb(page_table_, generation_of(min_seq_, page_class));
         }
-        
-        // Move all pages from younger to older generation
-        for (auto page_id : pages_to_move) {
-            auto it = page_table_.find(page_id);
-            if (it != page_table_.end()) {
-                // Remove from younger generation first
-                younger_gen.remove_page(it->second.lru_iterator);
-                
-                // Add to older generation
-                auto new_it = older_gen.add_page(page_id);
-                
-                // Update metadata
-                it->second.generation_index = i;
-                it->second.lru_iterator = new_it;
+        ++min_seq_;
+
+        // decay the feedback once per generation so old history fades out
+        for (auto& tiers : tier_stats_) {
+            for (TierStats& stats : tiers) {
+                stats.evicted >>= 1;
+                stats.refaulted >>= 1;
             }
         }
-        
-        // Clear younger generation tracker
-        younger_gen.get_tracker().clear();
     }
-    
-    // Clear oldest generation's tracker
-    generations_[oldest_idx].get_tracker().clear();
+
+    ++max_seq_;
+    const MglruClock::time_point birth = clock_();
+    for (size_t c = 0; c < NUM_PAGE_CLASSES; ++c) {
+        generation_of(max_seq_, static_cast<PageClass>(c)).set_birth(birth);
+    }
+
+    if (walk_mode_ != AgingWalk::None) {
+        walk_page_tables();
+    }
+}
+
+void MGLRU::walk_page_tables() {
+    // The walk opening max_seq reads the regions recorded for it and
+    // collects the young regions for the walk after it
+    const uint64_t seq = max_seq_;
+    const bool use_filter = walk_mode_ == AgingWalk::Bloom && filter_ready_;
+    young_regions_.reset(seq + 1);
+    ++walk_stats_.walks;
+
+    constexpr size_t words_per_region = PageTableRegions::PAGES_PER_REGION / AccessTracker::PAGES_PER_WORD;
+    for (size_t region = 0; region < regions_.num_regions(); ++region) {
+        if (regions_.mapped(region) == 0) {
+            ++walk_stats_.regions_empty;
+            continue;
+        }
+        if (use_filter && !young_regions_.may_be_young(seq, region)) {
+            ++walk_stats_.regions_filtered;
+            continue;
+        }
+        ++walk_stats_.regions_walked;
+
+        // one atomic op per 64 PTEs
+        bool young = false;
+        for (size_t w = 0; w < words_per_region; ++w) {
+            const PageFrameId base = PageTableRegions::first_page(region) + w * AccessTracker::PAGES_PER_WORD;
+            uint64_t bits = tracker_.test_and_clear_range(base);
+            while (bits != 0) {
+                const PageFrameId page_id = base + static_cast<PageFrameId>(__builtin_ctzll(bits));
+                bits &= bits - 1;
+                if (!is_tracked(page_id)) {
+                    continue;
+                }
+                PageMetadata& meta = page_table_[page_id];
+                if (meta.refs < UINT8_MAX) {
+                    ++meta.refs;
+                }
+                move_page(page_id, seq);
+                ++walk_stats_.young_pages;
+                young = true;
+            }
+        }
+        if (young) {
+            young_regions_.mark_young(seq + 1, region);
+        }
+    }
+    filter_ready_ = true;
 }
 
-void MGLRU::promote_page(PageMetadata& page_meta) {
-    size_t current_gen = page_meta.generation_index;
+void MGLRU::promote_page(PageFrameId page_id) {
+    PageMetadata& page_meta = page_table_[page_id];
+    uint64_t current_seq = effective_seq(page_meta);
     
     // Can't promote if already in youngest generation
-    if (current_gen == 0) {
+    if (current_seq == max_seq_) {
         return;
     }
     
-    // Remove from current generation
-    generations_[current_gen].remove_page(page_meta.lru_iterator);
-    
-    // Add to younger generation (current - 1)
-    size_t new_gen = current_gen - 1;
-    auto new_it = generations_[new_gen].add_page(page_meta.id);
-    
-    // Update metadata
-    page_meta.generation_index = new_gen;
-    page_meta.lru_iterator = new_it;
+    // Move to the next younger generation, relinking in place
+    move_page(page_id, current_seq + 1);
+}
+
+void MGLRU::move_page(PageFrameId page_id, uint64_t new_seq) {
+    PageMetadata& page_meta = page_table_[page_id];
+    uint64_t current_seq = effective_seq(page_meta);
+    if (current_seq == new_seq) {
+        return;
+    }
+    generation_of(current_seq, page_meta.page_class).remove_page(page_table_, page_id);
+    generation_of(new_seq, page_meta.page_class).add_page(page_table_, page_id);
+    page_meta.seq = new_seq;
 }
 
+size_t MGLRU::look_around(PageFrameId page_id) {
+    // pages are spatially clustered, so frames next to a hot one are likely
+    // hot as well; harvest their bits in one go instead of one op per page
+    const PageFrameId base = page_id & ~static_cast<PageFrameId>(AccessTracker::PAGES_PER_WORD - 1);
+    uint64_t bits = tracker_.test_and_clear_range(base);
+
+    // a hot neighbourhood found by eviction is worth walking at the next aging
+    if (walk_mode_ == AgingWalk::Bloom) {
+        young_regions_.mark_young(max_seq_ + 1, PageTableRegions::region_of(page_id));
+    }
+
+    size_t promoted = 0;
+    while (bits != 0) {
+        const PageFrameId neighbour = base + static_cast<PageFrameId>(__builtin_ctzll(bits));
+        bits &= bits - 1;
+        if (is_tracked(neighbour)) {
+            PageMetadata& meta = page_table_[neighbour];
+            if (meta.refs < UINT8_MAX) {
+                ++meta.refs;
+            }
+            promote_page(neighbour);
+            ++promoted;
+        }
+    }
+    return promoted;
+}
+
+void MGLRU::set_clock(std::function<MglruClock::time_point()> clock) {
+    clock_ = std::move(clock);
+}
+
+std::vector<GenerationInfo> MGLRU::generation_info() const {
+    std::vector<GenerationInfo> info;
+    for (uint64_t seq = min_seq_; seq <= max_seq_; ++seq) {
+        GenerationInfo gen;
+        gen.seq = seq;
+        gen.birth = generation_of(seq, PageClass::Anon).birth();
+        for (size_t c = 0; c < NUM_PAGE_CLASSES; ++c) {
+            gen.pages[c] = generation_of(seq, static_cast<PageClass>(c)).size();
+        }
+        info.push_back(gen);
+    }
+    return info;
+}
+
+size_t MGLRU::working_set_pages(std::chrono::nanoseconds window) const {
+    const MglruClock::time_point cutoff = clock_() - window;
+    size_t pages = 0;
+    // walk from the youngest down, birth times only decrease
+    for (uint64_t seq = max_seq_ + 1; seq-- > min_seq_;) {
+        const bool in_window = generation_of(seq, PageClass::Anon).birth() >= cutoff;
+        if (!in_window && seq != max_seq_) {
+            break;
+        }
+        for (size_t c = 0; c < NUM_PAGE_CLASSES; ++c) {
+            pages += generation_of(seq, static_cast<PageClass>(c)).size();
+        }
+    }
+    return pages;
+}
@@ -10,40 +10,177 @@
 
 #include "mglru_types.h"
 #include "generation.h"
-#include "pid_controller.h"
+#include "access_tracker.h"
+#include "page_table.h"
 
+#include <array>
+#include <chrono>
+#include <functional>
 #include <vector>
 #include <optional>
-#include <unordered_map>
 
 struct ReclaimResult {
     std::vector<PageFrameId> evicted_pages;
     size_t promoted_pages_count;
     size_t scanned_pages_count;
+    // unreferenced pages kept because their tier refaults more than tier 0
+    size_t protected_pages_count;
+    // generation the pages were evicted from, the stamp for shadow entries
+    uint64_t evicted_seq;
+    // all pages of one scan come from the same class
+    PageClass evicted_class;
+    // tier of each evicted page, parallel to evicted_pages
+    std::vector<uint8_t> evicted_tiers;
+};
+
+// how aging finds young pages that eviction has not looked at yet
+enum class AgingWalk {
+    None,   // aging only opens a generation, young pages wait for the scan
+    Full,   // walk every mapped page-table region
+    Bloom,  // walk only regions the Bloom filter saw young last time
+};
+
+struct WalkStats {
+    uint64_t walks = 0;
+    uint64_t regions_walked = 0;
+    uint64_t regions_filtered = 0;  // skipped by the Bloom filter
+    uint64_t regions_empty = 0;     // skipped, no mapped frames
+    uint64_t young_pages = 0;       // moved to the youngest generation
+};
+
+// one live generation, as reported for working-set estimation
+struct GenerationInfo {
+    uint64_t seq;
+    MglruClock::time_point birth;
+    std::array<size_t, NUM_PAGE_CLASSES> pages;
+};
+
+// decayed eviction / refault counts of one class and tier
+struct TierStats {
+    uint64_t evicted = 0;
+    uint64_t refaulted = 0;
 };
 
 
 class MGLRU {
 public:
-    MGLRU(size_t num_generations, size_t tracker_size_per_gen);
+    // capacity pre-sizes the page table and the accessed-bit map to the
+    // frame pool; both still grow on demand for larger frame IDs
+    explicit MGLRU(size_t num_generations, size_t capacity = 0);
     ~MGLRU() = default;
 
-    void on_page_added(PageFrameId page_id);
+    void on_page_added(PageFrameId page_id, PageClass page_class = PageClass::Anon);
 
     void on_page_accessed(PageFrameId page_id);
 
+    // Lock-free access path: only sets the accessed bit, the list move is
+    // deferred to scan_and_reclaim. Safe to call from any number of threads
+    // concurrently with the other members as long as the page table does not
+    // grow, i.e. every frame ID is below the constructor's capacity.
+    void record_access(PageFrameId page_id) { tracker_.set(page_id); }
+
+    // batched record_access, frames sharing a bitmap word cost one atomic op
+    void record_accesses(const PageFrameId* page_ids, size_t count);
+
+    // evict from the oldest generation of the class with the lower refault rate
     ReclaimResult scan_and_reclaim(size_t pages_to_scan);
 
-    void on_page_removed(const PageMetadata& page_meta);
+    // a page of this class and tier was evicted too early and came back
+    void on_refault(PageClass page_class, uint8_t tier);
+
+    const TierStats& get_tier_stats(PageClass page_class, size_t tier) const {
+        return tier_stats_[class_index(page_class)][tier];
+    }
+
+    // refault rate of a class over all tiers, or of one tier
+    double refault_rate(PageClass page_class) const;
+    double refault_rate(PageClass page_class, size_t tier) const;
+
+    static uint8_t tier_of(uint8_t refs);
+
+    // aging page-table walk, off by default
+    void set_aging_walk(AgingWalk mode) { walk_mode_ = mode; }
+    const WalkStats& get_walk_stats() const { return walk_stats_; }
+
+    // open a new youngest generation now, running the aging walk if enabled
+    void age() { age_generations(); }
+
+    // live generations from oldest (min_seq) to youngest (max_seq)
+    std::vector<GenerationInfo> generation_info() const;
+
+    // pages in generations born within `window` of now, i.e. pages that were
+    // added or found referenced during the window; the youngest generation
+    // always counts
+    size_t working_set_pages(std::chrono::nanoseconds window) const;
+
+    // clock used for generation birth times, replaceable for simulation
+    void set_clock(std::function<MglruClock::time_point()> clock);
+    MglruClock::time_point now() const { return clock_(); }
+    MglruClock::time_point youngest_birth() const { return generation_of(max_seq_, PageClass::Anon).birth(); }
+
+    void on_page_removed(PageFrameId page_id);
+
+    // number of pages currently tracked
+    size_t size() const { return page_count_; }
+    size_t size(PageClass page_class) const { return class_count_[class_index(page_class)]; }
+
+    // generation sequence numbers: max_seq is the youngest, min_seq the oldest
+    uint64_t get_max_seq() const { return max_seq_; }
+    uint64_t get_min_seq() const { return min_seq_; }
+    size_t num_generations() const { return max_generations_; }
 
 private:
+    // open a new youngest generation, O(1)
     void age_generations();
-    void promote_page(PageMetadata& page_meta);
+    void promote_page(PageFrameId page_id);
+    void move_page(PageFrameId page_id, uint64_t new_seq);
+    // move the young pages of the walked regions to max_seq
+    void walk_page_tables();
+    PageClass pick_class_to_scan();
+    // an unreferenced page whose tier refaults clearly more than tier 0
+    bool is_protected(const PageMetadata& page_meta) const;
+    // promote the other accessed pages sharing the word of a hot page,
+    // one atomic op for up to 64 neighbours
+    size_t look_around(PageFrameId page_id);
+    void ensure_capacity(PageFrameId page_id);
+    bool is_tracked(PageFrameId page_id) const {
+        return page_id < page_table_.size() && page_table_[page_id].present;
+    }
+
+    // generations form a ring indexed by sequence number,
+    // every slot holds one list per page class
+    Generation& generation_of(uint64_t seq, PageClass page_class) {
+        return generations_[(seq % max_generations_) * NUM_PAGE_CLASSES + class_index(page_class)];
+    }
+    const Generation& generation_of(uint64_t seq, PageClass page_class) const {
+        return generations_[(seq % max_generations_) * NUM_PAGE_CLASSES + class_index(page_class)];
+    }
+    size_t oldest_size() {
+        size_t total = 0;
+        for (size_t c = 0; c < NUM_PAGE_CLASSES; ++c) {
+            total += generation_of(min_seq_, static_cast<PageClass>(c)).size();
+        }
+        return total;
+    }
+    uint64_t effective_seq(const PageMetadata& page_meta) const {
+        return page_meta.seq < min_seq_ ? min_seq_ : page_meta.seq;
+    }
 
     std::vector<Generation> generations_;
-    PidController pid_controller_;
     size_t max_generations_;
-    std::unordered_map<PageFrameId, PageMetadata> page_table_;
+    uint64_t max_seq_;
+    uint64_t min_seq_;
+    PageTable page_table_;
+    AccessTracker tracker_;
+    PageTableRegions regions_;
+    YoungRegionFilter young_regions_;
+    AgingWalk walk_mode_ = AgingWalk::None;
+    bool filter_ready_ = false;  // the first walk has nothing to filter with
+    WalkStats walk_stats_;
+    std::function<MglruClock::time_point()> clock_;
+    size_t page_count_ = 0;
+    std::array<size_t, NUM_PAGE_CLASSES> class_count_{};
+    std::array<std::array<TierStats, NUM_TIERS>, NUM_PAGE_CLASSES> tier_stats_{};
 };
 
 #endif
\ No newline at end of file
@@ -1,6 +1,6 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:58:22
+@LastEditTime: 2025-11-12 21:08:40
 @Description: MGLRU Types Implementation
 @Language: C++17
 */
@@ -8,20 +8,57 @@
 #ifndef MGLRU_TYPES_H
 #define MGLRU_TYPES_H
 
+#include <chrono>
 #include <cstdint>
 #include <cstddef>
-#include <list>
+#include <vector>
 
 // to emulate the physical page frame
 using PageFrameId = std::uint64_t;
 
+// size of the emulated page frame, for byte-based interfaces
+constexpr std::size_t PAGE_SIZE = 4096;
+
+// generation birth times are taken from this clock
+using MglruClock = std::chrono::steady_clock;
+
+// 32-bit link used by the intrusive generation lists; frame IDs are dense
+// (0..capacity-1), so they double as indices into the page table
+using PageIndex = std::uint32_t;
+constexpr PageIndex INVALID_PAGE = UINT32_MAX;
+
+// page classes with separate lists and refault feedback, like the anon and
+// file LRUs of the kernel: their refault costs differ, so they are balanced
+// by measured refault rate instead of treated as one pool
+enum class PageClass : std::uint8_t {
+    Anon = 0,
+    File = 1,
+};
+constexpr std::size_t NUM_PAGE_CLASSES = 2;
+
+// tiers split a generation by how often a page was found referenced:
+// tier = floor(log2(refs + 1)), capped at NUM_TIERS - 1
+constexpr std::size_t NUM_TIERS = 4;
+
+inline std::size_t class_index(PageClass page_class) {
+    return static_cast<std::size_t>(page_class);
+}
 
 // core data in page frame
 // O(1) access to page frame
 struct PageMetadata {
-    PageFrameId id;
-    size_t generation_index;
-    std::list<PageFrameId>::iterator lru_iterator;
+    // sequence number of the generation the page was last placed in;
+    // the effective generation is max(seq, min_seq) since aging splices
+    // the oldest list into the next one without touching each page
+    uint64_t seq = 0;
+    PageIndex prev = INVALID_PAGE;  // towards the head (younger)
+    PageIndex next = INVALID_PAGE;  // towards the tail (older)
+    bool present = false;           // page is tracked by MGLRU
+    PageClass page_class = PageClass::Anon;
+    std::uint8_t refs = 0;          // times found referenced by the scan, saturating
 };
 
-#endif
\ No newline at end of file
+// dense page table indexed by PageFrameId
+using PageTable = std::vector<PageMetadata>;
+
+#endif
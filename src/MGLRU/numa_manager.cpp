@@ -0,0 +1,137 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-17 21:38:20
+@Description: MGLRU NUMA Memory Manager Implementation
+@Language: C++17
+*/
+
+#include "numa_memory_manager.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+NumaMemoryManager::NumaMemoryManager(size_t num_nodes, size_t capacity_per_node,
+                                     size_t num_generations, NumaPolicy policy)
+    : capacity_per_node_(capacity_per_node),
+      policy_(policy),
+      distances_(num_nodes * num_nodes, REMOTE_DISTANCE),
+      counters_(new NodeCounters[num_nodes]) {
+    if (num_nodes == 0 || capacity_per_node == 0) {
+        throw std::invalid_argument("NUMA manager needs at least one node with frames");
+    }
+
+    nodes_.reserve(num_nodes);
+    for (size_t n = 0; n < num_nodes; ++n) {
+        nodes_.push_back(std::make_unique<MemoryManager>(capacity_per_node, num_generations));
+        distances_[n * num_nodes + n] = LOCAL_DISTANCE;
+    }
+}
+
+void NumaMemoryManager::check_node(size_t node) const {
+    if (node >= nodes_.size()) {
+        throw std::out_of_range("NUMA node out of range");
+    }
+}
+
+void NumaMemoryManager::set_distance(size_t from, size_t to, uint32_t distance) {
+    check_node(from);
+    check_node(to);
+    distances_[from * nodes_.size() + to] = distance;
+}
+
+std::optional<PageFrameId> NumaMemoryManager::allocate_page(size_t node, PageClass page_class) {
+    return allocate(node, MemoryManager::NO_KEY, page_class);
+}
+
+std::optional<PageFrameId> NumaMemoryManager::allocate_page(size_t node, PageKey key, PageClass page_class) {
+    return allocate(node, key, page_class);
+}
+
+std::vector<size_t> NumaMemoryManager::fallback_order(size_t node) {
+    std::vector<size_t> order(nodes_.size());
+    if (policy_ == NumaPolicy::Interleave) {
+        size_t first = interleave_next_.fetch_add(1, std::memory_order_relaxed) % nodes_.size();
+        for (size_t i = 0; i < order.size(); ++i) {
+            order[i] = (first + i) % nodes_.size();
+        }
+        return order;
+    }
+
+    // local first, then by distance; ties keep node order
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this, node](size_t a, size_t b) {
+        return distance(node, a) < distance(node, b);
+    });
+    return order;
+}
+
+std::optional<PageFrameId> NumaMemoryManager::allocate(size_t node, PageKey key, PageClass page_class) {
+    check_node(node);
+    const std::vector<size_t> order = fallback_order(node);
+
+    auto account = [this, node](size_t served_by, PageFrameId local_id) {
+        if (served_by == node) {
+            counters_[node].local_allocations.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            counters_[node].remote_allocations.fetch_add(1, std::memory_order_relaxed);
+            counters_[served_by].foreign_allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        return served_by * capacity_per_node_ + local_id;
+    };
+
+    // Fast path: a free frame on any node in policy order, no reclaim
+    for (size_t candidate : order) {
+        if (auto page = nodes_[candidate]->try_allocate_page(key, page_class)) {
+            return account(candidate, *page);
+        }
+    }
+
+    // Slow path: every node is full, stall in direct reclaim in the same order
+    for (size_t candidate : order) {
+        if (auto page = nodes_[candidate]->allocate_page(key, page_class)) {
+            return account(candidate, *page);
+        }
+    }
+
+    counters_[node].failed_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::nullopt;
+}
+
+void NumaMemoryManager::access_page(PageFrameId page_id, size_t from_node) {
+    const size_t owner = node_of(page_id);
+    if (owner >= nodes_.size() || from_node >= nodes_.size()) {
+        return;
+    }
+    NodeCounters& counters = counters_[from_node];
+    if (owner == from_node) {
+        counters.local_accesses.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        counters.remote_accesses.fetch_add(1, std::memory_order_relaxed);
+    }
+    counters.access_cost.fetch_add(distance(from_node, owner), std::memory_order_relaxed);
+    nodes_[owner]->access_page(page_id - owner * capacity_per_node_);
+}
+
+void NumaMemoryManager::free_page(PageFrameId page_id) {
+    const size_t owner = node_of(page_id);
+    check_node(owner);
+    nodes_[owner]->free_page(page_id - owner * capacity_per_node_);
+}
+
+NodeStats NumaMemoryManager::get_node_stats(size_t node) const {
+    check_node(node);
+    const NodeCounters& counters = counters_[node];
+    NodeStats stats;
+    stats.local_allocations = counters.local_allocations.load(std::memory_order_relaxed);
+    stats.remote_allocations = counters.remote_allocations.load(std::memory_order_relaxed);
+    stats.foreign_allocations = counters.foreign_allocations.load(std::memory_order_relaxed);
+    stats.failed_allocations = counters.failed_allocations.load(std::memory_order_relaxed);
+    stats.local_accesses = counters.local_accesses.load(std::memory_order_relaxed);
+    stats.remote_accesses = counters.remote_accesses.load(std::memory_order_relaxed);
+    stats.access_cost = counters.access_cost.load(std::memory_order_relaxed);
+    stats.memory_usage = nodes_[node]->get_memory_usage();
+    stats.memory = nodes_[node]->get_stats();
+    return stats;
+}
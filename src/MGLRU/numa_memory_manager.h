@@ -0,0 +1,103 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-17 21:05:33
+@Description: MGLRU NUMA Memory Manager Implementation
+@Language: C++17
+*/
+
+#ifndef NUMA_MEMORY_MANAGER_H
+#define NUMA_MEMORY_MANAGER_H
+
+#include "memory_manager.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+enum class NumaPolicy {
+    LocalFirst,  // requesting node first, then the others by distance
+    Interleave,  // round-robin over all nodes, spreads bandwidth
+};
+
+struct NodeStats {
+    // allocations requested on this node and served by it / by another node
+    size_t local_allocations = 0;
+    size_t remote_allocations = 0;
+    // allocations this node served for another node's request
+    size_t foreign_allocations = 0;
+    size_t failed_allocations = 0;
+    // accesses issued from this node to local / remote frames
+    size_t local_accesses = 0;
+    size_t remote_accesses = 0;
+    // sum of node distances over all accesses, 10 per local access
+    uint64_t access_cost = 0;
+    double memory_usage = 0.0;
+    MemoryStats memory;
+};
+
+// N independent memory nodes, each a MemoryManager with its own frame pool,
+// MGLRU, watermarks and reclaim thread. Frame IDs are global: node n owns
+// [n * capacity_per_node, (n + 1) * capacity_per_node).
+class NumaMemoryManager {
+public:
+    static constexpr uint32_t LOCAL_DISTANCE = 10;
+    static constexpr uint32_t REMOTE_DISTANCE = 21;
+
+    NumaMemoryManager(size_t num_nodes, size_t capacity_per_node, size_t num_generations,
+                      NumaPolicy policy = NumaPolicy::LocalFirst);
+    ~NumaMemoryManager() = default;
+
+    NumaMemoryManager(const NumaMemoryManager&) = delete;
+    NumaMemoryManager& operator=(const NumaMemoryManager&) = delete;
+
+    // allocate for a task running on `node`; falls back to other nodes
+    // according to the policy before stalling in direct reclaim
+    std::optional<PageFrameId> allocate_page(size_t node, PageClass page_class = PageClass::Anon);
+    std::optional<PageFrameId> allocate_page(size_t node, PageKey key, PageClass page_class = PageClass::Anon);
+
+    // access from a task running on `from_node`, lock-free
+    void access_page(PageFrameId page_id, size_t from_node);
+
+    void free_page(PageFrameId page_id);
+
+    size_t node_of(PageFrameId page_id) const { return page_id / capacity_per_node_; }
+    size_t num_nodes() const { return nodes_.size(); }
+
+    // SLIT-style distance, LOCAL_DISTANCE on the diagonal
+    uint32_t distance(size_t from, size_t to) const { return distances_[from * nodes_.size() + to]; }
+    void set_distance(size_t from, size_t to, uint32_t distance);
+
+    void set_policy(NumaPolicy policy) { policy_ = policy; }
+
+    NodeStats get_node_stats(size_t node) const;
+
+    // nodes to try for a request from `node`, best first;
+    // advances the round-robin cursor under Interleave
+    std::vector<size_t> fallback_order(size_t node);
+
+private:
+    struct NodeCounters {
+        std::atomic<size_t> local_allocations{0};
+        std::atomic<size_t> remote_allocations{0};
+        std::atomic<size_t> foreign_allocations{0};
+        std::atomic<size_t> failed_allocations{0};
+        std::atomic<size_t> local_accesses{0};
+        std::atomic<size_t> remote_accesses{0};
+        std::atomic<uint64_t> access_cost{0};
+    };
+
+    std::optional<PageFrameId> allocate(size_t node, PageKey key, PageClass page_class);
+
+    void check_node(size_t node) const;
+
+    const size_t capacity_per_node_;
+    NumaPolicy policy_;
+    std::vector<std::unique_ptr<MemoryManager>> nodes_;
+    std::vector<uint32_t> distances_;
+    std::unique_ptr<NodeCounters[]> counters_;
+    std::atomic<size_t> interleave_next_{0};
+};
+
+#endif
@@ -0,0 +1,46 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-16 20:51:27
+@Description: MGLRU Page Table Walk Implementation
+@Language: C++17
+*/
+
+#include "page_table.h"
+
+#include <algorithm>
+
+PageTableRegions::PageTableRegions(size_t num_pages)
+    : mapped_((num_pages + PAGES_PER_REGION - 1) / PAGES_PER_REGION, 0) {
+}
+
+void PageTableRegions::resize(size_t num_pages) {
+    mapped_.resize((num_pages + PAGES_PER_REGION - 1) / PAGES_PER_REGION, 0);
+}
+
+namespace {
+
+crp::utils::BloomFilterParams filter_params(size_t expected_regions) {
+    // 1% false positives, the kernel uses a similarly small filter per walk
+    return crp::utils::BloomFilterParams(std::max<size_t>(expected_regions, 64), 0.01);
+}
+
+} // namespace
+
+YoungRegionFilter::YoungRegionFilter(size_t expected_regions)
+    : filters_{crp::utils::BloomFilter(filter_params(expected_regions)),
+               crp::utils::BloomFilter(filter_params(expected_regions))} {
+}
+
+bool YoungRegionFilter::may_be_young(uint64_t seq, size_t region) const {
+    const uint64_t key = region;
+    return filters_[slot(seq)].contains(key);
+}
+
+void YoungRegionFilter::mark_young(uint64_t seq, size_t region) {
+    const uint64_t key = region;
+    filters_[slot(seq)].add(key);
+}
+
+void YoungRegionFilter::reset(uint64_t seq) {
+    filters_[slot(seq)].clear();
+}
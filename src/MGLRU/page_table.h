@@ -0,0 +1,66 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-16 20:35:51
+@Description: MGLRU Page Table Walk Implementation
+@Language: C++17
+*/
+
+#ifndef MGLRU_PAGE_TABLE_H
+#define MGLRU_PAGE_TABLE_H
+
+#include "mglru_types.h"
+#include "../../include/utils/bloom_filter.h"
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+// Simulated page table: frames are grouped into PMD-sized regions
+// (512 x 4 KiB = 2 MiB), each covering 8 words of the accessed-bit map.
+// Only the number of mapped frames per region is kept, which is what the
+// walk needs to skip empty page-table pages.
+class PageTableRegions {
+public:
+    static constexpr size_t PAGES_PER_REGION = 512;
+
+    explicit PageTableRegions(size_t num_pages);
+
+    void resize(size_t num_pages);
+
+    void map(PageFrameId page_id) { ++mapped_[region_of(page_id)]; }
+    void unmap(PageFrameId page_id) { --mapped_[region_of(page_id)]; }
+
+    size_t mapped(size_t region) const { return mapped_[region]; }
+    size_t num_regions() const { return mapped_.size(); }
+
+    static size_t region_of(PageFrameId page_id) { return page_id / PAGES_PER_REGION; }
+    static PageFrameId first_page(size_t region) { return region * PAGES_PER_REGION; }
+
+private:
+    std::vector<uint32_t> mapped_;
+};
+
+// Two Bloom filters of region indices, used alternately by consecutive
+// aging walks: the walk that opens generation seq reads filter seq % 2 and
+// records the regions it found young into filter (seq + 1) % 2 for the next
+// walk. Look-around during eviction feeds the filter the next walk reads.
+// A false positive only costs an extra region walk.
+class YoungRegionFilter {
+public:
+    explicit YoungRegionFilter(size_t expected_regions);
+
+    // was the region young during the walk or scans feeding generation seq
+    bool may_be_young(uint64_t seq, size_t region) const;
+
+    void mark_young(uint64_t seq, size_t region);
+
+    // start collecting regions for generation seq
+    void reset(uint64_t seq);
+
+private:
+    static size_t slot(uint64_t seq) { return seq & 1; }
+
+    std::array<crp::utils::BloomFilter, 2> filters_;
+};
+
+#endif
@@ -1,6 +1,6 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:58:32  
+@LastEditTime: 2025-11-14 21:03:18  
 @Description: PID Controller for MGLRU scan intensity
 @Language: C++17
 */
@@ -8,41 +8,49 @@
 #include "pid_controller.h"
 #include <algorithm>
 
-PidController::PidController(double p, double i, double d) 
-    : Kp_(p), Ki_(i), Kd_(d) {
+namespace {
+
+constexpr double MIN_EFFICIENCY = 1.0 / 32;
+constexpr double INTEGRAL_LIMIT = 100.0;
+constexpr size_t MAX_INTENSITY = 1024;
+
+} // namespace
+
+PidController::PidController(double p, double i, double d, size_t base_intensity) 
+    : Kp_(p), Ki_(i), Kd_(d), base_intensity_(base_intensity) {
 }
 
-void PidController::update_metrics(size_t refaults, size_t scanned, size_t reclaimed) {
-    (void)scanned;  // Reserved for future use
-    
-    // Calculate error: we want to minimize refaults while maintaining efficiency
-    // Error is the ratio of refaults to reclaimed pages
-    double error = 0.0;
-    if (reclaimed > 0) {
-        error = static_cast<double>(refaults) / static_cast<double>(reclaimed);
+void PidController::update_metrics(size_t refaults, size_t scanned, size_t reclaimed, size_t stalls) {
+    // Exponentially smoothed scan efficiency, only meaningful when we scanned
+    if (scanned > 0) {
+        double efficiency = static_cast<double>(reclaimed) / static_cast<double>(scanned);
+        efficiency_ = 0.5 * efficiency_ + 0.5 * efficiency;
     }
+
+    // Error: stalls push the budget up, refaults pull it down.
+    // Normalized by the work done so the gains do not depend on pool size.
+    double denom = static_cast<double>(std::max<size_t>(reclaimed + stalls, 1));
+    double error = (static_cast<double>(stalls) - static_cast<double>(refaults)) / denom;
     
-    // PID control
-    integral_ += error;
-    // double derivative = error - prev_error_;  // Reserved for future use
+    // PID control, one update per reclaim period (dt = 1)
+    derivative_ = error - prev_error_;
     prev_error_ = error;
+    integral_ += error;
     
     // Clamp integral to prevent windup
-    integral_ = std::clamp(integral_, -100.0, 100.0);
+    integral_ = std::clamp(integral_, -INTEGRAL_LIMIT, INTEGRAL_LIMIT);
 }
 
 size_t PidController::get_scan_intensity() const {
     // Calculate PID output
-    double output = Kp_ * prev_error_ + Ki_ * integral_ + Kd_ * (prev_error_ - integral_);
+    double output = Kp_ * prev_error_ + Ki_ * integral_ + Kd_ * derivative_;
     
-    // Convert to scan intensity (number of pages to scan)
-    // Base intensity + adjustment based on PID output
-    size_t base_intensity = 32;  // scan 32 pages by default
-    double adjustment = output * 10.0;
-    
-    size_t intensity = base_intensity + static_cast<size_t>(std::max(0.0, adjustment));
+    // Convert to scan intensity (number of pages to scan):
+    // the output scales the base budget, scan efficiency stretches it
+    double scale = std::max(1.0 + output, MIN_EFFICIENCY);
+    double pages = static_cast<double>(base_intensity_) * scale / std::max(efficiency_, MIN_EFFICIENCY);
     
     // Clamp to reasonable range
-    return std::clamp(intensity, size_t(1), size_t(1024));
+    pages = std::clamp(pages, 1.0, static_cast<double>(MAX_INTENSITY));
+    return static_cast<size_t>(pages);
 }
-
@@ -1,6 +1,6 @@
 /*
 @Author: Lzww
-@LastEditTime: 2025-10-26 21:58:32
+@LastEditTime: 2025-11-14 21:03:18
 @Description: MGLRU PID Controller Implementation
 @Language: C++17
 */
@@ -10,24 +10,37 @@
 
 #include <cstddef>
 
+// Sets the background reclaim scan budget.
+// The control error is positive when reclaim falls behind (allocations had to
+// stall in direct reclaim) and negative when it is too aggressive (evicted
+// pages refault soon after), both per page reclaimed in the last period.
+// The scan budget is then scaled by the inverse of the scan efficiency, since
+// fewer reclaimable pages per scanned page means more pages to scan.
 class PidController {
 public:
-    PidController(double p, double i, double d);
+    PidController(double p, double i, double d, size_t base_intensity = 32);
     ~PidController() = default;
 
     // update the metrics for the PID controller
     // refaults: number of page that are faulted and revisited in short time 
     // scanned: number of page that are scanned
     // reclaimed: number of page that are successfully collected
-    void update_metrics(size_t refaults, size_t scanned, size_t reclaimed);
+    // stalls: number of page that allocations had to reclaim synchronously
+    void update_metrics(size_t refaults, size_t scanned, size_t reclaimed, size_t stalls = 0);
 
     size_t get_scan_intensity() const;
 
+    double get_error() const { return prev_error_; }
+    double get_efficiency() const { return efficiency_; }
+
 private:
     double Kp_, Ki_, Kd_;
+    size_t base_intensity_;
     double integral_ = 0.0;
     double prev_error_ = 0.0;
-    // others
+    double derivative_ = 0.0;
+    // smoothed reclaimed / scanned
+    double efficiency_ = 1.0;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,65 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-14 20:27:03
+@Description: MGLRU Shadow Entries Implementation
+@Language: C++17
+*/
+
+#include "shadow_table.h"
+
+namespace {
+
+size_t round_up_pow2(size_t n) {
+    size_t size = 1;
+    while (size < n) {
+        size <<= 1;
+    }
+    return size;
+}
+
+} // namespace
+
+ShadowTable::ShadowTable(size_t capacity)
+    : slots_(round_up_pow2(capacity == 0 ? 1 : capacity)),
+      mask_(slots_.size() - 1) {
+}
+
+uint64_t ShadowTable::hash(PageKey key) {
+    // splitmix64 finalizer, spreads sequential keys over the table
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+void ShadowTable::insert(PageKey key, uint64_t seq, PageClass page_class, uint8_t tier) {
+    static_assert(NUM_PAGE_CLASSES <= 2 && NUM_TIERS <= 4, "shadow stamp layout");
+    uint64_t h = hash(key);
+    uint32_t tag = static_cast<uint32_t>(h >> 32);
+    Slot& slot = slots_[h & mask_];
+    slot.tag = tag == 0 ? 1 : tag;
+    slot.stamp = static_cast<uint32_t>(seq & ((1ULL << SEQ_BITS) - 1)) |
+                 (static_cast<uint32_t>(class_index(page_class)) << SEQ_BITS) |
+                 (static_cast<uint32_t>(tier & 0x3) << (SEQ_BITS + 1));
+}
+
+std::optional<ShadowEntry> ShadowTable::lookup_and_erase(PageKey key) {
+    uint64_t h = hash(key);
+    uint32_t tag = static_cast<uint32_t>(h >> 32);
+    Slot& slot = slots_[h & mask_];
+    if (slot.tag != (tag == 0 ? 1 : tag)) {
+        return std::nullopt;
+    }
+    ShadowEntry entry;
+    entry.seq = slot.stamp & ((1U << SEQ_BITS) - 1);
+    entry.page_class = static_cast<PageClass>((slot.stamp >> SEQ_BITS) & 0x1);
+    entry.tier = static_cast<uint8_t>((slot.stamp >> (SEQ_BITS + 1)) & 0x3);
+    slot = Slot{};
+    return entry;
+}
+
+void ShadowTable::clear() {
+    for (auto& slot : slots_) {
+        slot = Slot{};
+    }
+}
@@ -0,0 +1,71 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-14 20:12:46
+@Description: MGLRU Shadow Entries Implementation
+@Language: C++17
+*/
+
+#ifndef SHADOW_TABLE_H
+#define SHADOW_TABLE_H
+
+#include "mglru_types.h"
+
+#include <vector>
+#include <optional>
+#include <cstddef>
+
+// logical identity of the data held by a frame (e.g. file offset or virtual
+// page number); frames are recycled, the key is what refaults are matched on
+using PageKey = std::uint64_t;
+
+// Shadow entries: when a page is evicted its key is remembered together with
+// the generation it was evicted from, so a later re-allocation of the same
+// key can tell how long the page stayed out (the refault distance).
+// The class and tier of the evicted page ride along so the refault can be
+// charged to them. The table is a direct-mapped hash of 8-byte slots and is lossy on purpose:
+// a colliding eviction overwrites the older shadow, like the kernel shrinking
+// its shadow nodes under pressure.
+struct ShadowEntry {
+    uint64_t seq;  // truncated to SEQ_BITS, compare with ShadowTable::seq_distance
+    PageClass page_class;
+    uint8_t tier;
+};
+
+class ShadowTable {
+public:
+    static constexpr unsigned SEQ_BITS = 28;
+
+    // capacity is rounded up to a power of 2
+    explicit ShadowTable(size_t capacity);
+    ~ShadowTable() = default;
+
+    // remember that `key` was evicted from generation `seq`
+    void insert(PageKey key, uint64_t seq, PageClass page_class = PageClass::Anon, uint8_t tier = 0);
+
+    // eviction record of `key` if a shadow survived; the shadow is consumed
+    std::optional<ShadowEntry> lookup_and_erase(PageKey key);
+
+    // generations between a stored (truncated) stamp and the current seq
+    static uint64_t seq_distance(uint64_t current_seq, uint64_t stored_seq) {
+        return (current_seq - stored_seq) & ((1ULL << SEQ_BITS) - 1);
+    }
+
+    void clear();
+
+    size_t capacity() const { return slots_.size(); }
+
+private:
+    // upper hash bits tag the slot, 0 marks an empty slot;
+    // stamp packs seq (low SEQ_BITS), the class bit and a 2-bit tier
+    struct Slot {
+        uint32_t tag = 0;
+        uint32_t stamp = 0;
+    };
+
+    static uint64_t hash(PageKey key);
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+};
+
+#endif
@@ -14,8 +14,8 @@
 
 namespace SRRIP {
 
-template <uint8_t RRPV_M_BITS>
-SRRIPCache<RRPV_M_BITS>::SRRIPCache(size_t cache_size_kb, size_t block_size_bytes, size_t associativity)
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+SRRIPCache<RRPV_M_BITS, METADATA_ONLY>::SRRIPCache(size_t cache_size_kb, size_t block_size_bytes, size_t associativity)
     : associativity_(associativity), num_sets_(0), offset_bits_(0), set_index_bits_(0) {
     if (cache_size_kb == 0 || block_size_bytes == 0 || associativity == 0) {
         throw std::invalid_argument("Cache parameters must be positive");
@@ -51,22 +51,19 @@ SRRIPCache<RRPV_M_BITS>::SRRIPCache(size_t cache_size_kb, size_t block_size_byte
     // initialize all the sets
     sets_.reserve(num_sets_);
     for (size_t i = 0; i < num_sets_; ++i) {
-        sets_.emplace_back(associativity);
+        sets_.emplace_back(associativity, i);
     }
 }
 
-template <uint8_t RRPV_M_BITS>
-void SRRIPCache<RRPV_M_BITS>::parseAddress(uint64_t address, uint64_t& tag, size_t& set_index) const {
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+void SRRIPCache<RRPV_M_BITS, METADATA_ONLY>::parseAddress(uint64_t address, uint64_t& tag, size_t& set_index) const {
     set_index = (address >> offset_bits_) & ((1ULL << set_index_bits_) - 1);
     tag = address >> (offset_bits_ + set_index_bits_);
 }
 
-template <uint8_t RRPV_M_BITS>
-bool SRRIPCache<RRPV_M_BITS>::access(uint64_t address) {
-    uint64_t tag;
-    size_t set_index;
-    parseAddress(address, tag, set_index);
-
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+typename SRRIPCache<RRPV_M_BITS, METADATA_ONLY>::AccessOutcome
+SRRIPCache<RRPV_M_BITS, METADATA_ONLY>::accessSet(size_t set_index, uint64_t tag) {
     assert(set_index < num_sets_ && "Invalid set index");
 
     auto& target_set = sets_[set_index];
@@ -74,28 +71,61 @@ bool SRRIPCache<RRPV_M_BITS>::access(uint64_t address) {
 
     if (way.has_value()) {
         target_set.accessWay(way.value());
-        hit_count_.fetch_add(1, std::memory_order_relaxed);
-        return true;
-    } else {
-        miss_count_.fetch_add(1, std::memory_order_relaxed);
+        return AccessOutcome::Hit;
+    }
+
+    // 1. find empty block
+    auto empty_way = target_set.findEmptyWay();
+    if (empty_way.has_value()) {
+        target_set.fillWay(empty_way.value(), tag);
+        return AccessOutcome::Fill;
+    }
 
-        // 1. find empty block
-        auto empty_way = target_set.findEmptyWay();
-        if (empty_way.has_value()) {
-            target_set.fillWay(empty_way.value(), tag);
-            return false;
-        }
+    // 2. find victim and replace it 
+    size_t victim_way = target_set.findVictimWay();
+    target_set.fillWay(victim_way, tag);
+    return AccessOutcome::Replace;
+}
 
-        // 2. find victim and replace it 
-        size_t victim_way = target_set.findVictimWay();
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+bool SRRIPCache<RRPV_M_BITS, METADATA_ONLY>::access(uint64_t address) {
+    uint64_t tag;
+    size_t set_index;
+    parseAddress(address, tag, set_index);
+
+    switch (accessSet(set_index, tag)) {
+    case AccessOutcome::Hit:
+        hit_count_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    case AccessOutcome::Replace:
         replace_count_.fetch_add(1, std::memory_order_relaxed);
-        target_set.fillWay(victim_way, tag);
+        [[fallthrough]];
+    case AccessOutcome::Fill:
+        miss_count_.fetch_add(1, std::memory_order_relaxed);
         return false;
     }
+    return false;
+}
+
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+void SRRIPCache<RRPV_M_BITS, METADATA_ONLY>::replay(const uint64_t* addresses, size_t count, size_t num_threads) {
+    num_threads = SetReplayPool::resolveThreads(num_threads, num_sets_);
+    if (!replay_pool_ || replay_pool_->threads() != num_threads) {
+        replay_pool_ = std::make_unique<SetReplayPool>(num_threads);
+    }
+
+    ReplayCounts counts = replay_pool_->replay(
+        addresses, count, set_index_bits_,
+        [this](uint64_t address, uint64_t& tag, size_t& set_index) { parseAddress(address, tag, set_index); },
+        [this](size_t set_index, uint64_t tag) { return accessSet(set_index, tag); });
+
+    hit_count_.fetch_add(counts.hits, std::memory_order_relaxed);
+    miss_count_.fetch_add(counts.misses, std::memory_order_relaxed);
+    replace_count_.fetch_add(counts.replacements, std::memory_order_relaxed);
 }
 
-template <uint8_t RRPV_M_BITS>
-uint64_t SRRIPCache<RRPV_M_BITS>::getHitRate() const noexcept {
+template <uint8_t RRPV_M_BITS, bool METADATA_ONLY>
+uint64_t SRRIPCache<RRPV_M_BITS, METADATA_ONLY>::getHitRate() const noexcept {
     uint64_t hits = hit_count_.load(std::memory_order_relaxed);
     uint64_t misses = miss_count_.load(std::memory_order_relaxed);
     uint64_t total = hits + misses;
@@ -6,15 +6,14 @@
 */
 
 #include "../../include/SRRIP/srrip_cache.h"
-#include "../../include/SRRIP/cache_set.h"
 #include "srrip_cache.cpp"
-#include "cache_set.cpp"
 
 // 显式实例化常用配置
 template class SRRIP::SRRIPCache<2>;  // 4个RRPV值 (0,1,2,3)
 template class SRRIP::SRRIPCache<3>;  // 8个RRPV值 (0,1,2,3,4,5,6,7)
 template class SRRIP::SRRIPCache<4>;  // 16个RRPV值
 
-template class SRRIP::CacheSet<2>;
-template class SRRIP::CacheSet<3>;
-template class SRRIP::CacheSet<4>;
+// 仅元数据模式（CompactCacheLine）
+template class SRRIP::SRRIPCache<2, true>;
+template class SRRIP::SRRIPCache<3, true>;
+template class SRRIP::SRRIPCache<4, true>;
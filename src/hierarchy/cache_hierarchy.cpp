@@ -0,0 +1,148 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-9 22:26:51
+@Description: 多级缓存层次模拟实现
+@Language: C++17
+*/
+
+#include "../../include/hierarchy/cache_hierarchy.h"
+
+#include <stdexcept>
+
+namespace Hierarchy {
+
+CacheHierarchy::CacheHierarchy(std::vector<std::unique_ptr<CacheLevel>> levels, InclusionPolicy policy)
+    : levels_(std::move(levels)), policy_(policy) {
+    if (levels_.empty()) {
+        throw std::invalid_argument("hierarchy needs at least one level");
+    }
+    for (const auto& level : levels_) {
+        if (!level) {
+            throw std::invalid_argument("hierarchy level must not be null");
+        }
+        if (level->blockSize() != levels_.front()->blockSize()) {
+            throw std::invalid_argument("all levels must use the same block size");
+        }
+    }
+    stats_.resize(levels_.size());
+}
+
+size_t CacheHierarchy::access(uint64_t address, bool is_write) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    ++total_accesses_;
+
+    const size_t n = levels_.size();
+    size_t hit_level = n;
+    for (size_t i = 0; i < n; ++i) {
+        auto& stats = stats_[i];
+        ++stats.accesses;
+
+        bool hit;
+        if (i > 0 && policy_ == InclusionPolicy::Exclusive) {
+            // 独占式：下级命中的行上移到 L1，本级失效
+            auto dirty = levels_[i]->invalidate(address);
+            hit = dirty.has_value();
+            if (hit) {
+                is_write = is_write || dirty.value();
+            }
+        } else {
+            // 只有 L1 接收写操作，下级的行在写回时才变脏
+            hit = levels_[i]->lookup(address, is_write && i == 0);
+        }
+
+        if (hit) {
+            ++stats.hits;
+            hit_level = i;
+            break;
+        }
+        ++stats.misses;
+    }
+
+    if (hit_level == n) {
+        ++memory_reads_;
+    }
+    if (hit_level == 0) {
+        return 0;
+    }
+
+    if (policy_ == InclusionPolicy::Exclusive) {
+        fillLevel(0, address, is_write);
+    } else {
+        // 自下而上填充，包含式下级先持有该行
+        for (size_t i = hit_level; i-- > 0;) {
+            fillLevel(i, address, is_write && i == 0);
+        }
+    }
+    return hit_level;
+}
+
+void CacheHierarchy::fillLevel(size_t index, uint64_t address, bool dirty) {
+    if (auto victim = levels_[index]->fill(address, dirty)) {
+        handleVictim(index, victim.value());
+    }
+}
+
+void CacheHierarchy::handleVictim(size_t index, Victim victim) {
+    ++stats_[index].evictions;
+
+    if (policy_ == InclusionPolicy::Inclusive) {
+        // 维持包含性：上级副本一并失效，其脏数据合并到牺牲者
+        for (size_t upper = 0; upper < index; ++upper) {
+            if (auto dirty = levels_[upper]->invalidate(victim.address)) {
+                ++stats_[upper].back_invalidations;
+                victim.dirty = victim.dirty || dirty.value();
+            }
+        }
+    }
+
+    if (policy_ == InclusionPolicy::Exclusive) {
+        // 独占式：牺牲者（无论脏否）下沉到下一级，LLC 的脏牺牲者写回内存
+        if (victim.dirty) {
+            ++stats_[index].writebacks;
+        }
+        if (index + 1 < levels_.size()) {
+            fillLevel(index + 1, victim.address, victim.dirty);
+        } else if (victim.dirty) {
+            ++memory_writebacks_;
+        }
+        return;
+    }
+
+    if (victim.dirty) {
+        ++stats_[index].writebacks;
+        writeback(index + 1, victim.address);
+    }
+}
+
+void CacheHierarchy::writeback(size_t index, uint64_t address) {
+    if (index == levels_.size()) {
+        ++memory_writebacks_;
+        return;
+    }
+    // 非包含式下级可能已替换掉该行，此时写分配
+    if (!levels_[index]->markDirty(address)) {
+        fillLevel(index, address, true);
+    }
+}
+
+LevelStats CacheHierarchy::getLevelStats(size_t index) const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return stats_.at(index);
+}
+
+uint64_t CacheHierarchy::getMemoryReads() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return memory_reads_;
+}
+
+uint64_t CacheHierarchy::getMemoryWritebacks() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return memory_writebacks_;
+}
+
+double CacheHierarchy::getGlobalMissRate() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return total_accesses_ == 0 ? 0.0 : static_cast<double>(memory_reads_) / total_accesses_;
+}
+
+} // namespace Hierarchy
@@ -0,0 +1,67 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-9 21:40:03
+@Description: 层次模拟中的 LRU 组实现
+@Language: C++17
+*/
+
+#include "../../include/hierarchy/cache_level.h"
+
+namespace Hierarchy {
+
+LRUSet::LRUSet(size_t associativity, uint64_t /*seed*/) {
+    if (associativity == 0) {
+        throw std::invalid_argument("associativity must be positive");
+    }
+    ways_.resize(associativity);
+}
+
+std::optional<size_t> LRUSet::findWay(uint64_t tag) const {
+    for (size_t i = 0; i < ways_.size(); i++) {
+        if (ways_[i].valid && ways_[i].tag == tag) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<size_t> LRUSet::findEmptyWay() const {
+    for (size_t i = 0; i < ways_.size(); i++) {
+        if (!ways_[i].valid) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+size_t LRUSet::findVictimWay() {
+    size_t victim = 0;
+    for (size_t i = 1; i < ways_.size(); i++) {
+        if (ways_[i].last_use < ways_[victim].last_use) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+void LRUSet::accessWay(size_t way_index) {
+    ways_[way_index].last_use = ++clock_;
+}
+
+void LRUSet::fillWay(size_t way_index, uint64_t tag) {
+    auto& line = ways_[way_index];
+    line.valid = true;
+    line.dirty = false;
+    line.tag = tag;
+    line.last_use = ++clock_;
+}
+
+void LRUSet::markDirty(size_t way_index) {
+    ways_[way_index].dirty = true;
+}
+
+void LRUSet::invalidateWay(size_t way_index) {
+    ways_[way_index] = Line{};
+}
+
+} // namespace Hierarchy
@@ -0,0 +1,337 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-5 22:40:18
+@Description: 二进制内存访问 trace 读取实现
+@Language: C++17
+*/
+
+#include "../../include/trace/trace_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace Trace {
+
+//===================================================================
+// MappedTraceReader
+//===================================================================
+
+MappedTraceReader::MappedTraceReader(const std::string& path, size_t batch_size)
+    : batch_size_(batch_size) {
+    if (batch_size == 0) {
+        throw std::invalid_argument("batch size must be positive");
+    }
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open trace: " + path + ": " + std::strerror(errno));
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error("cannot stat trace: " + path + ": " + std::strerror(err));
+    }
+
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    if (bytes % sizeof(uint64_t) != 0) {
+        ::close(fd);
+        throw std::runtime_error("trace size is not a multiple of 8 bytes: " + path);
+    }
+
+    // mmap 不接受长度 0，空 trace 直接视为读完
+    if (bytes > 0) {
+        void* addr = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot mmap trace: " + path + ": " + std::strerror(err));
+        }
+        ::madvise(addr, bytes, MADV_SEQUENTIAL);
+        mapping_ = addr;
+        mapped_bytes_ = bytes;
+        data_ = static_cast<const uint64_t*>(addr);
+        count_ = bytes / sizeof(uint64_t);
+    }
+    ::close(fd);
+}
+
+MappedTraceReader::~MappedTraceReader() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapped_bytes_);
+    }
+}
+
+size_t MappedTraceReader::nextBatch(const uint64_t*& batch) {
+    const size_t n = std::min(batch_size_, count_ - pos_);
+    batch = data_ + pos_;
+    pos_ += n;
+    return n;
+}
+
+//===================================================================
+// StreamingTraceReader
+//===================================================================
+
+StreamingTraceReader::StreamingTraceReader(std::unique_ptr<StreamDecoder> decoder, size_t batch_size)
+    : decoder_(std::move(decoder)) {
+    if (!decoder_) {
+        throw std::invalid_argument("decoder must not be null");
+    }
+    if (batch_size == 0) {
+        throw std::invalid_argument("batch size must be positive");
+    }
+    for (auto& buffer : buffers_) {
+        buffer.addresses.resize(batch_size);
+    }
+    decode_thread_ = std::thread(&StreamingTraceReader::decodeLoop, this);
+}
+
+StreamingTraceReader::~StreamingTraceReader() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (decode_thread_.joinable()) {
+        decode_thread_.join();
+    }
+}
+
+void StreamingTraceReader::decodeLoop() {
+    try {
+        for (size_t index = 0; ; index ^= 1) {
+            Buffer& buffer = buffers_[index];
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                cv_.wait(lock, [&] { return !buffer.ready || stop_; });
+                if (stop_) {
+                    return;
+                }
+            }
+
+            // 锁外解码：消费者此时只会读取另一个缓冲区
+            auto* dst = reinterpret_cast<char*>(buffer.addresses.data());
+            const size_t capacity = buffer.addresses.size() * sizeof(uint64_t);
+            size_t filled = 0;
+            while (filled < capacity) {
+                size_t n = decoder_->read(dst + filled, capacity - filled);
+                if (n == 0) {
+                    break;
+                }
+                filled += n;
+            }
+            if (filled % sizeof(uint64_t) != 0) {
+                throw std::runtime_error("compressed trace ends with a partial address");
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                buffer.count = filled / sizeof(uint64_t);
+                // 空缓冲区即流结束标记
+                buffer.ready = true;
+            }
+            cv_.notify_all();
+            if (filled == 0) {
+                return;
+            }
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            error_ = std::current_exception();
+        }
+        cv_.notify_all();
+    }
+}
+
+size_t StreamingTraceReader::nextBatch(const uint64_t*& batch) {
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    // 归还上一批，解码线程可以继续填充它
+    if (has_current_) {
+        buffers_[consume_index_].ready = false;
+        consume_index_ ^= 1;
+        has_current_ = false;
+        cv_.notify_all();
+    }
+
+    Buffer& buffer = buffers_[consume_index_];
+    cv_.wait(lock, [&] { return buffer.ready || error_; });
+    if (!buffer.ready && error_) {
+        std::rethrow_exception(error_);
+    }
+    if (buffer.count == 0) {
+        // 结束标记保持 ready，重复调用仍返回 0
+        return 0;
+    }
+
+    has_current_ = true;
+    batch = buffer.addresses.data();
+    return buffer.count;
+}
+
+//===================================================================
+// Decoders
+//===================================================================
+
+#ifdef HAVE_ZLIB
+namespace {
+
+class GzipDecoder : public StreamDecoder {
+public:
+    explicit GzipDecoder(const std::string& path) {
+        file_ = ::gzopen(path.c_str(), "rb");
+        if (file_ == nullptr) {
+            throw std::runtime_error("cannot open gzip trace: " + path);
+        }
+        ::gzbuffer(file_, 1 << 17);
+    }
+
+    ~GzipDecoder() override {
+        ::gzclose(file_);
+    }
+
+    size_t read(void* dst, size_t len) override {
+        // gzread 的长度参数为 unsigned int
+        const unsigned chunk = static_cast<unsigned>(std::min<size_t>(len, INT_MAX));
+        int n = ::gzread(file_, dst, chunk);
+        if (n < 0) {
+            int errnum = 0;
+            throw std::runtime_error(std::string("gzip trace decode error: ") + ::gzerror(file_, &errnum));
+        }
+        if (n == 0) {
+            // 流提前结束时gzread返回0, 只有gzerror报告Z_BUF_ERROR
+            int errnum = Z_OK;
+            ::gzerror(file_, &errnum);
+            if (errnum != Z_OK) {
+                throw std::runtime_error("gzip trace is truncated");
+            }
+        }
+        return static_cast<size_t>(n);
+    }
+
+private:
+    gzFile file_{nullptr};
+};
+
+} // namespace
+#endif // HAVE_ZLIB
+
+#ifdef HAVE_ZSTD
+namespace {
+
+class ZstdDecoder : public StreamDecoder {
+public:
+    explicit ZstdDecoder(const std::string& path)
+        : in_(ZSTD_DStreamInSize()) {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (file_ == nullptr) {
+            throw std::runtime_error("cannot open zstd trace: " + path + ": " + std::strerror(errno));
+        }
+        dstream_ = ZSTD_createDStream();
+        if (dstream_ == nullptr) {
+            std::fclose(file_);
+            throw std::runtime_error("cannot create zstd decompression stream");
+        }
+        ZSTD_initDStream(dstream_);
+    }
+
+    ~ZstdDecoder() override {
+        ZSTD_freeDStream(dstream_);
+        std::fclose(file_);
+    }
+
+    size_t read(void* dst, size_t len) override {
+        ZSTD_outBuffer out{dst, len, 0};
+        while (out.pos < out.size) {
+            if (input_.pos == input_.size && !eof_) {
+                size_t n = std::fread(in_.data(), 1, in_.size(), file_);
+                if (n == 0) {
+                    if (std::ferror(file_)) {
+                        throw std::runtime_error("zstd trace read error");
+                    }
+                    eof_ = true;
+                }
+                input_ = ZSTD_inBuffer{in_.data(), n, 0};
+            }
+
+            const size_t before = out.pos;
+            const size_t consumed_before = input_.pos;
+            size_t ret = ZSTD_decompressStream(dstream_, &out, &input_);
+            if (ZSTD_isError(ret)) {
+                throw std::runtime_error(std::string("zstd trace decode error: ") + ZSTD_getErrorName(ret));
+            }
+            // 空输入且无输出的调用返回的是下一帧的输入提示, 不代表当前帧未完成
+            if (input_.pos != consumed_before || out.pos != before) {
+                frame_remaining_ = ret;
+            }
+
+            // 输入耗尽且解码器已无输出可刷新
+            if (eof_ && out.pos == before) {
+                if (frame_remaining_ != 0) {
+                    throw std::runtime_error("zstd trace is truncated");
+                }
+                break;
+            }
+        }
+        return out.pos;
+    }
+
+private:
+    std::FILE* file_{nullptr};
+    ZSTD_DStream* dstream_{nullptr};
+    std::vector<char> in_;
+    ZSTD_inBuffer input_{nullptr, 0, 0};
+    size_t frame_remaining_{0};
+    bool eof_{false};
+};
+
+} // namespace
+#endif // HAVE_ZSTD
+
+namespace {
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+std::unique_ptr<TraceReader> openTrace(const std::string& path) {
+    if (endsWith(path, ".gz")) {
+#ifdef HAVE_ZLIB
+        return std::make_unique<StreamingTraceReader>(std::make_unique<GzipDecoder>(path));
+#else
+        throw std::runtime_error("gzip trace support not compiled in (zlib not found): " + path);
+#endif
+    }
+    if (endsWith(path, ".zst")) {
+#ifdef HAVE_ZSTD
+        return std::make_unique<StreamingTraceReader>(std::make_unique<ZstdDecoder>(path));
+#else
+        throw std::runtime_error("zstd trace support not compiled in (libzstd not found): " + path);
+#endif
+    }
+    return std::make_unique<MappedTraceReader>(path);
+}
+
+} // namespace Trace
@@ -9,6 +9,8 @@
 #include <string>
 #include <cassert>
 #include <chrono>
+#include <thread>
+#include <vector>
 
 void testBasicFunctionality() {
     std::cout << "=== 测试基本功能 ===" << std::endl;
@@ -123,11 +125,10 @@ void testMultiShardBehavior() {
         cache.put("key" + std::to_string(i), i);
     }
     
-    // 验证一些数据仍然可访问
-    int value;
+    // 验证一些数据仍然驻留 (get命中幽灵会把键放回缓存, 用contains计数)
     int found_count = 0;
     for (int i = 0; i < 50; ++i) {
-        if (cache.get("key" + std::to_string(i), value)) {
+        if (cache.contains("key" + std::to_string(i))) {
             found_count++;
         }
     }
@@ -135,9 +136,112 @@ void testMultiShardBehavior() {
     std::cout << "在50个键中找到: " << found_count << "个" << std::endl;
     assert(found_count > 0 && found_count <= 16);  // 应该在合理范围内
     
+    // 容量小于分片数时分片数降为c, 每个分片至少1个条目, 总容量仍为c
+    ARCCache<std::string, int> tiny(1, 3, 16);
+    assert(tiny.shard_count() == 3);
+    assert(tiny.getStats().total_capacity == 3);
+    for (int i = 0; i < 20; ++i) {
+        tiny.put("key" + std::to_string(i), i);
+    }
+    auto tiny_stats = tiny.getStats();
+    assert(tiny_stats.t1_size + tiny_stats.t2_size <= 3);
+    
     std::cout << "✓ 多分片行为测试通过" << std::endl;
 }
 
+void testShardAdaptation() {
+    std::cout << "=== 测试分片独立调整p ===" << std::endl;
+    
+    // std::hash<int>是恒等映射, 偶数键落在分片0, 奇数键落在分片1
+    ARCCache<int, int, std::hash<int>> cache(2, 8, 2);  // 每分片 p=1, c=4
+    assert(cache.getShardStats(0).target_p == 1);
+    assert(cache.getShardStats(1).target_p == 1);
+    
+    // 分片0: 6个新键, 前两个被淘汰进B1
+    for (int i = 0; i < 12; i += 2) {
+        cache.put(i, i);
+    }
+    assert(cache.getShardStats(0).b1_size > 0);
+    
+    // 命中B1, 分片0的p增大, 分片1不受影响
+    int value;
+    assert(cache.get(0, value) == true && value == 0);
+    assert(cache.getShardStats(0).target_p > 1);
+    assert(cache.getShardStats(1).target_p == 1);
+    assert(cache.getStats().target_p == cache.getShardStats(0).target_p + 1);
+    
+    std::cout << "✓ 分片独立调整p测试通过" << std::endl;
+}
+
+void testRebalance() {
+    std::cout << "=== 测试全局再平衡 ===" << std::endl;
+    
+    ARCCache<int, int, std::hash<int>> cache(0, 16, 2);  // 每分片 p=0, c=8
+    
+    // 分片0反复命中B1, p升高
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 24; i += 2) {
+            cache.put(i, i);
+        }
+    }
+    size_t p0 = cache.getShardStats(0).target_p;
+    size_t p1 = cache.getShardStats(1).target_p;
+    assert(p0 > p1);
+    
+    // 再平衡把差距缩小一半左右, 总和基本不变
+    cache.rebalance();
+    size_t q0 = cache.getShardStats(0).target_p;
+    size_t q1 = cache.getShardStats(1).target_p;
+    assert(q0 - q1 < p0 - p1);
+    assert(q0 + q1 <= p0 + p1 && q0 + q1 + 2 >= p0 + p1);
+    
+    // 自动再平衡: 每4次操作一次
+    ARCCache<int, int, std::hash<int>> auto_cache(0, 16, 2, 4);
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 0; i < 24; i += 2) {
+            auto_cache.put(i, i);
+        }
+    }
+    assert(auto_cache.getShardStats(1).target_p > 0);
+    
+    std::cout << "✓ 全局再平衡测试通过" << std::endl;
+}
+
+void testConcurrentAccess() {
+    std::cout << "=== 测试并发访问 ===" << std::endl;
+    
+    ARCCache<int, int, std::hash<int>> cache(64, 128, 8, 256);
+    const int num_threads = 4;
+    const int ops_per_thread = 20000;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&cache, t]() {
+            int value;
+            for (int i = 0; i < ops_per_thread; ++i) {
+                int key = (i * 7 + t * 13) % 512;
+                if (!cache.get(key, value)) {
+                    cache.put(key, key);
+                } else {
+                    assert(value == key);
+                }
+                if (i % 97 == 0) {
+                    cache.remove(key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    auto stats = cache.getStats();
+    assert(stats.t1_size + stats.t2_size <= stats.total_capacity);
+    assert(stats.target_p <= stats.total_capacity);
+    
+    std::cout << "✓ 并发访问测试通过" << std::endl;
+}
+
 void performanceBenchmark() {
     std::cout << "=== 性能基准测试 ===" << std::endl;
     
@@ -147,8 +251,8 @@ void performanceBenchmark() {
     auto start = std::chrono::high_resolution_clock::now();
     
     // 写入测试
-    for (int i = 0; i < num_operations; ++i) {
-        cache.put("key" + std::to_string(i), i);
+    for (uint64_t i = 0; i < num_operations; ++i) {
+        cache.put("key" + std::to_string(i), static_cast<int>(i));
     }
     
     auto mid = std::chrono::high_resolution_clock::now();
@@ -156,10 +260,10 @@ void performanceBenchmark() {
     // 读取测试 - 只读取后面的数据（应该还在缓存中）
     int value;
     int hit_count = 0;
-    int test_start = num_operations - 2000;  // 测试最后2000个数据
+    const uint64_t test_start = num_operations - 2000;  // 测试最后2000个数据
     int test_count = 2000;
     
-    for (int i = test_start; i < num_operations; ++i) {
+    for (uint64_t i = test_start; i < num_operations; ++i) {
         if (cache.get("key" + std::to_string(i), value)) {
             hit_count++;
         }
@@ -218,7 +322,7 @@ void realisticWorkloadTest() {
     std::cout << "总操作数: " << operations << std::endl;
     std::cout << "命中次数: " << hit_count << std::endl;
     std::cout << "命中率: " << (hit_count * 100.0 / operations) << "%" << std::endl;
-    std::cout << "查询性能: " << operations * 1000000 / duration.count() << " ops/sec" << std::endl;
+    std::cout << "查询性能: " << operations * 1000000LL / duration.count() << " ops/sec" << std::endl;
     
     auto stats = cache.getStats();
     std::cout << "缓存状态 - T1:" << stats.t1_size << ", T2:" << stats.t2_size 
@@ -237,6 +341,9 @@ int main() {
         testRemoveOperation();
         testParameterValidation();
         testMultiShardBehavior();
+        testShardAdaptation();
+        testRebalance();
+        testConcurrentAccess();
         performanceBenchmark();
         realisticWorkloadTest();
         
@@ -0,0 +1,49 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-10-30 21:10:00
+@Description: BRRIP缓存测试套件
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+
+#include "../src/BRRIP/brrip_cache.h"
+
+using namespace BRRIP;
+
+TEST(BRRIPCacheTest, ConstructorTest) {
+    EXPECT_NO_THROW({
+        BRRIPCache<2> cache(64, 64, 4);
+    });
+
+    EXPECT_THROW({
+        BRRIPCache<2> cache(0, 64, 4);
+    }, std::invalid_argument);
+
+    EXPECT_THROW({
+        BRRIPCache<2> cache(64, 63, 4);
+    }, std::invalid_argument);
+}
+
+TEST(BRRIPCacheTest, BasicAccessTest) {
+    BRRIPCache<2> cache(64, 64, 4);
+
+    EXPECT_FALSE(cache.access(0x1000));
+    EXPECT_EQ(cache.getMissCount(), 1);
+
+    EXPECT_TRUE(cache.access(0x1000));
+    EXPECT_EQ(cache.getHitCount(), 1);
+}
+
+TEST(BRRIPCacheTest, ReplacementTest) {
+    BRRIPCache<2> cache(64, 64, 4);
+
+    // 256 组，同一组内的地址间隔为 64 * 256 = 0x4000
+    cache.access(0x0000);
+    cache.access(0x4000);
+    cache.access(0x8000);
+    cache.access(0xC000);
+
+    EXPECT_FALSE(cache.access(0x10000));
+    EXPECT_EQ(cache.getReplaceCount(), 1);
+}
@@ -0,0 +1,163 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-9 23:05:30
+@Description: 多级缓存层次测试套件
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "../include/hierarchy/cache_hierarchy.h"
+
+using namespace Hierarchy;
+
+namespace {
+
+constexpr size_t BLOCK = 64;
+
+// 两级全相联 LRU：每级 1KB / 16 路，即单组 16 行
+CacheHierarchy makeTwoLevelLRU(InclusionPolicy policy) {
+    std::vector<std::unique_ptr<CacheLevel>> levels;
+    levels.push_back(std::make_unique<LRULevel>("L1", 1, BLOCK, 16));
+    levels.push_back(std::make_unique<LRULevel>("L2", 1, BLOCK, 16));
+    return CacheHierarchy(std::move(levels), policy);
+}
+
+void cyclicPass(CacheHierarchy& hierarchy, size_t blocks, bool is_write = false) {
+    for (size_t i = 0; i < blocks; ++i) {
+        hierarchy.access(i * BLOCK, is_write);
+    }
+}
+
+} // namespace
+
+TEST(CacheHierarchyTest, ConstructorValidation) {
+    std::vector<std::unique_ptr<CacheLevel>> none;
+    EXPECT_THROW(CacheHierarchy(std::move(none), InclusionPolicy::NINE), std::invalid_argument);
+
+    std::vector<std::unique_ptr<CacheLevel>> mismatched;
+    mismatched.push_back(std::make_unique<LRULevel>("L1", 1, 64, 4));
+    mismatched.push_back(std::make_unique<LRULevel>("L2", 4, 128, 4));
+    EXPECT_THROW(CacheHierarchy(std::move(mismatched), InclusionPolicy::NINE), std::invalid_argument);
+
+    EXPECT_THROW(LRULevel("L1", 1, 63, 4), std::invalid_argument);
+}
+
+TEST(CacheHierarchyTest, HitLevelReporting) {
+    std::vector<std::unique_ptr<CacheLevel>> levels;
+    levels.push_back(std::make_unique<LRULevel>("L1", 1, BLOCK, 16));
+    levels.push_back(std::make_unique<LRULevel>("L2", 4, BLOCK, 64));
+    CacheHierarchy hierarchy(std::move(levels), InclusionPolicy::Inclusive);
+
+    EXPECT_EQ(hierarchy.access(0x0), 2u);   // 内存
+    EXPECT_EQ(hierarchy.access(0x0), 0u);   // L1
+
+    // 32 个块超出 L1 但装得下 L2
+    cyclicPass(hierarchy, 32);
+    EXPECT_EQ(hierarchy.access(0x0), 1u);   // 已被挤出 L1，L2 命中
+
+    auto l1 = hierarchy.getLevelStats(0);
+    auto l2 = hierarchy.getLevelStats(1);
+    EXPECT_EQ(l1.accesses, l1.hits + l1.misses);
+    EXPECT_EQ(l2.accesses, l1.misses);
+    EXPECT_EQ(hierarchy.getMemoryReads(), l2.misses);
+}
+
+TEST(CacheHierarchyTest, ExclusiveAggregatesCapacity) {
+    // 24 块的循环工作集：独占式总容量 32 行可全部容纳，包含式只有 16 行会持续颠簸
+    auto exclusive = makeTwoLevelLRU(InclusionPolicy::Exclusive);
+    auto inclusive = makeTwoLevelLRU(InclusionPolicy::Inclusive);
+
+    for (int pass = 0; pass < 3; ++pass) {
+        cyclicPass(exclusive, 24);
+        cyclicPass(inclusive, 24);
+    }
+
+    EXPECT_EQ(exclusive.getMemoryReads(), 24u);
+    EXPECT_EQ(inclusive.getMemoryReads(), 72u);
+    EXPECT_GT(exclusive.getLevelStats(1).hits, 0u);
+}
+
+TEST(CacheHierarchyTest, InclusiveBackInvalidation) {
+    // L2 比 L1 小时，L2 替换必然反向失效 L1 中的行
+    std::vector<std::unique_ptr<CacheLevel>> levels;
+    levels.push_back(std::make_unique<LRULevel>("L1", 2, BLOCK, 32));
+    levels.push_back(std::make_unique<LRULevel>("L2", 1, BLOCK, 16));
+    CacheHierarchy hierarchy(std::move(levels), InclusionPolicy::Inclusive);
+
+    cyclicPass(hierarchy, 24);
+    EXPECT_EQ(hierarchy.getLevelStats(0).back_invalidations, 8u);
+    // 被反向失效的块在 L1 中也不复存在
+    EXPECT_EQ(hierarchy.access(0x0), 2u);
+
+    // NINE 下同样的配置 L1 保留这些块
+    std::vector<std::unique_ptr<CacheLevel>> nine_levels;
+    nine_levels.push_back(std::make_unique<LRULevel>("L1", 2, BLOCK, 32));
+    nine_levels.push_back(std::make_unique<LRULevel>("L2", 1, BLOCK, 16));
+    CacheHierarchy nine(std::move(nine_levels), InclusionPolicy::NINE);
+
+    cyclicPass(nine, 24);
+    EXPECT_EQ(nine.getLevelStats(0).back_invalidations, 0u);
+    EXPECT_EQ(nine.access(0x0), 0u);
+}
+
+TEST(CacheHierarchyTest, DirtyVictimsWriteBack) {
+    std::vector<std::unique_ptr<CacheLevel>> levels;
+    levels.push_back(std::make_unique<LRULevel>("LLC", 1, BLOCK, 16));
+    CacheHierarchy single(std::move(levels), InclusionPolicy::NINE);
+
+    cyclicPass(single, 16, true);
+    for (size_t i = 16; i < 32; ++i) {
+        single.access(i * BLOCK);
+    }
+    EXPECT_EQ(single.getMemoryWritebacks(), 16u);
+    EXPECT_EQ(single.getLevelStats(0).writebacks, 16u);
+
+    // 两级：L1 的脏行先写回 L2，L2 替换时才写回内存
+    for (auto policy : {InclusionPolicy::Inclusive, InclusionPolicy::Exclusive, InclusionPolicy::NINE}) {
+        std::vector<std::unique_ptr<CacheLevel>> two;
+        two.push_back(std::make_unique<LRULevel>("L1", 1, BLOCK, 16));
+        two.push_back(std::make_unique<LRULevel>("L2", 4, BLOCK, 64));
+        CacheHierarchy hierarchy(std::move(two), policy);
+
+        cyclicPass(hierarchy, 16, true);
+        for (size_t i = 16; i < 32; ++i) {
+            hierarchy.access(i * BLOCK);
+        }
+        EXPECT_EQ(hierarchy.getLevelStats(0).writebacks, 16u);
+        EXPECT_EQ(hierarchy.getMemoryWritebacks(), 0u);
+
+        // 把 L2 也挤满，脏行最终写回内存
+        for (size_t i = 32; i < 200; ++i) {
+            hierarchy.access(i * BLOCK);
+        }
+        EXPECT_EQ(hierarchy.getMemoryWritebacks(), 16u);
+    }
+}
+
+TEST(CacheHierarchyTest, MixedRRIPLevels) {
+    for (auto policy : {InclusionPolicy::Inclusive, InclusionPolicy::Exclusive, InclusionPolicy::NINE}) {
+        std::vector<std::unique_ptr<CacheLevel>> levels;
+        levels.push_back(std::make_unique<LRULevel>("L1", 32, BLOCK, 8));
+        levels.push_back(std::make_unique<SRRIPLevel<2>>("L2", 256, BLOCK, 8));
+        levels.push_back(std::make_unique<BRRIPLevel<2, true>>("LLC", 2048, BLOCK, 16));
+        CacheHierarchy hierarchy(std::move(levels), policy);
+
+        std::mt19937_64 gen(3);
+        std::uniform_int_distribution<uint64_t> dis(0, (1ULL << 16) - 1);
+        const size_t n = 100000;
+        for (size_t i = 0; i < n; ++i) {
+            hierarchy.access(dis(gen) * BLOCK, (i & 3) == 0);
+        }
+
+        EXPECT_EQ(hierarchy.getLevelStats(0).accesses, n);
+        for (size_t i = 1; i < hierarchy.numLevels(); ++i) {
+            EXPECT_EQ(hierarchy.getLevelStats(i).accesses, hierarchy.getLevelStats(i - 1).misses);
+        }
+        EXPECT_EQ(hierarchy.getMemoryReads(), hierarchy.getLevelStats(2).misses);
+        EXPECT_GT(hierarchy.getGlobalMissRate(), 0.0);
+        EXPECT_LT(hierarchy.getGlobalMissRate(), 1.0);
+    }
+}
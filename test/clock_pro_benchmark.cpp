@@ -0,0 +1,187 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 15:18:44
+@Description: Clock-Pro / LIRS / Clock 命中率与吞吐对比基准
+@Language: C++17
+*/
+
+// LIRS first: clock_cache.h #defines DEFAULT_CAPACITY, which LIRS declares as a constant
+#include "../include/LIRS/cache.h"
+#include "../src/LIRS/cache.cpp"
+#include "../include/Clock/clock_cache.h"
+#include "../include/Clock/clock_pro_cache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Trace = std::vector<int>;
+
+class BenchmarkTimer {
+private:
+    std::chrono::high_resolution_clock::time_point start_time;
+
+public:
+    void start() {
+        start_time = std::chrono::high_resolution_clock::now();
+    }
+
+    double stop() {
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+        return duration.count() / 1000.0; // 返回毫秒
+    }
+};
+
+// skewed popularity: key k is drawn with probability ~ 1 / (k + 1)^0.9
+Trace makeZipfTrace(size_t length, int keys, uint32_t seed) {
+    std::vector<double> weights(keys);
+    for (int k = 0; k < keys; ++k) {
+        weights[k] = 1.0 / std::pow(k + 1.0, 0.9);
+    }
+    std::discrete_distribution<int> dist(weights.begin(), weights.end());
+    std::mt19937 rng(seed);
+    Trace trace(length);
+    for (auto& key : trace) {
+        key = dist(rng);
+    }
+    return trace;
+}
+
+// a loop slightly larger than the cache: LRU and CLOCK miss on every access
+Trace makeLoopTrace(size_t length, int loop) {
+    Trace trace(length);
+    for (size_t i = 0; i < length; ++i) {
+        trace[i] = static_cast<int>(i % loop);
+    }
+    return trace;
+}
+
+// a hot working set interleaved with a one-time scan
+Trace makeScanTrace(size_t length, int hot, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> hot_dist(0, hot - 1);
+    Trace trace(length);
+    int next_scan = hot;
+    for (size_t i = 0; i < length; ++i) {
+        trace[i] = i % 2 == 0 ? hot_dist(rng) : next_scan++;
+    }
+    return trace;
+}
+
+// returns the hit ratio of a get-then-put-on-miss replay
+template <typename Lookup, typename Insert>
+double replay(const Trace& trace, Lookup lookup, Insert insert) {
+    size_t hits = 0;
+    for (int key : trace) {
+        if (lookup(key)) {
+            ++hits;
+        } else {
+            insert(key);
+        }
+    }
+    return static_cast<double>(hits) / trace.size();
+}
+
+void compareHitRatio(const char* name, const Trace& trace, size_t capacity) {
+    BenchmarkTimer timer;
+
+    ClockProCache<int, int, std::hash<int>> clock_pro(capacity);
+    timer.start();
+    double clock_pro_ratio = replay(trace,
+        [&](int key) { int value; return clock_pro.get(key, value); },
+        [&](int key) { clock_pro.put(key, key); });
+    double clock_pro_ms = timer.stop();
+
+    LIRS::LIRSCache<int, int, std::hash<int>> lirs(capacity);
+    timer.start();
+    double lirs_ratio = replay(trace,
+        [&](int key) { return lirs.get(key).has_value(); },
+        [&](int key) { lirs.put(key, key); });
+    double lirs_ms = timer.stop();
+
+    ClockCache<int, int, std::hash<int>> clock(capacity);
+    timer.start();
+    double clock_ratio = replay(trace,
+        [&](int key) { int value; return clock.get(key, value); },
+        [&](int key) { clock.put(key, key); });
+    double clock_ms = timer.stop();
+
+    std::printf("%-22s %10.4f %10.4f %10.4f   %8.1f %8.1f %8.1f\n", name,
+                clock_pro_ratio, lirs_ratio, clock_ratio, clock_pro_ms, lirs_ms, clock_ms);
+}
+
+// concurrent hits on a warm cache; LIRS serializes every get on its mutex
+template <typename Get>
+double concurrentHitThroughput(int threads, int ops_per_thread, int keys, Get get) {
+    std::atomic<long> hits{0};
+    BenchmarkTimer timer;
+    timer.start();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::mt19937 rng(t + 1);
+            std::uniform_int_distribution<int> dist(0, keys - 1);
+            long local = 0;
+            for (int i = 0; i < ops_per_thread; ++i) {
+                local += get(dist(rng));
+            }
+            hits += local;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double ms = timer.stop();
+    return threads * static_cast<double>(ops_per_thread) / ms / 1000.0;  // Mops/s
+}
+
+void compareConcurrentHits(size_t capacity) {
+    const int keys = static_cast<int>(capacity / 2);
+    const int ops = 500000;
+
+    ClockProCache<int, int, std::hash<int>> clock_pro(capacity);
+    LIRS::LIRSCache<int, int, std::hash<int>> lirs(capacity);
+    ClockCache<int, int, std::hash<int>> clock(capacity);
+    for (int key = 0; key < keys; ++key) {
+        clock_pro.put(key, key);
+        lirs.put(key, key);
+        clock.put(key, key);
+    }
+
+    std::printf("\n%-10s %14s %14s %14s   (Mops/s, all hits)\n", "threads", "ClockPro", "LIRS", "Clock");
+    for (int threads : {1, 2, 4, 8}) {
+        double clock_pro_mops = concurrentHitThroughput(threads, ops, keys,
+            [&](int key) { int value; return clock_pro.get(key, value); });
+        double lirs_mops = concurrentHitThroughput(threads, ops, keys,
+            [&](int key) { return lirs.get(key).has_value(); });
+        double clock_mops = concurrentHitThroughput(threads, ops, keys,
+            [&](int key) { int value; return clock.get(key, value); });
+        std::printf("%-10d %14.2f %14.2f %14.2f\n", threads, clock_pro_mops, lirs_mops, clock_mops);
+    }
+}
+
+} // namespace
+
+int main() {
+    const size_t capacity = 10000;
+    const size_t length = 2000000;
+
+    std::printf("=== Clock-Pro vs LIRS vs Clock, capacity %zu ===\n\n", capacity);
+    std::printf("%-22s %10s %10s %10s   %8s %8s %8s\n", "workload",
+                "ClockPro", "LIRS", "Clock", "ms", "ms", "ms");
+    compareHitRatio("zipf 0.9, 100k keys", makeZipfTrace(length, 100000, 1), capacity);
+    compareHitRatio("loop 1.2x capacity", makeLoopTrace(length, capacity * 12 / 10), capacity);
+    compareHitRatio("hot 0.8x + scan", makeScanTrace(length, capacity * 8 / 10, 2), capacity);
+
+    compareConcurrentHits(capacity);
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 14:52:06
+@Description: Clock-Pro缓存单元测试 (Google Test)
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include "../include/Clock/clock_pro_cache.h"
+#include "../include/LIRS/cache.h"
+#include "../src/LIRS/cache.cpp"
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ClockProCacheTest, BasicPutGetRemove) {
+    ClockProCache<std::string, int> cache(4);
+    cache.put("a", 1);
+    cache.put("b", 2);
+
+    int value = 0;
+    ASSERT_TRUE(cache.get("a", value));
+    EXPECT_EQ(value, 1);
+    EXPECT_FALSE(cache.get("c", value));
+
+    cache.put("a", 10);
+    ASSERT_TRUE(cache.get("a", value));
+    EXPECT_EQ(value, 10);
+    EXPECT_EQ(cache.size(), 2u);
+
+    cache.remove("a");
+    EXPECT_FALSE(cache.contains("a"));
+    EXPECT_EQ(cache.size(), 1u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_THROW((ClockProCache<int, int, std::hash<int>>(0)), std::invalid_argument);
+}
+
+TEST(ClockProCacheTest, EvictedPagesStayOnTest) {
+    ClockProCache<int, int, std::hash<int>> cache(4);
+    for (int key = 0; key < 8; ++key) {
+        cache.put(key, key);
+    }
+    // the first pages fill the hot set, the rest come in cold and on test
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_EQ(cache.hot_size(), 3u);
+    EXPECT_EQ(cache.test_size(), 4u);
+
+    // a test hit comes back hot and widens the cold window
+    size_t target = cache.cold_target();
+    int evicted = -1;
+    for (int key = 0; key < 8; ++key) {
+        if (!cache.contains(key)) {
+            evicted = key;
+            break;
+        }
+    }
+    ASSERT_GE(evicted, 0);
+    cache.put(evicted, evicted);
+    EXPECT_TRUE(cache.contains(evicted));
+    EXPECT_GT(cache.cold_target(), target);
+    // one older hot page turned cold to make room for it
+    EXPECT_EQ(cache.hot_size(), 3u);
+    EXPECT_EQ(cache.cold_size(), 1u);
+    EXPECT_EQ(cache.size(), 4u);
+}
+
+TEST(ClockProCacheTest, CountsStayBounded) {
+    const size_t capacity = 500;
+    ClockProCache<int, int, std::hash<int>> cache(capacity);
+    std::mt19937 rng(7);
+    for (int i = 0; i < 200000; ++i) {
+        int key = i % 3 == 0 ? static_cast<int>(rng() % 50000) : static_cast<int>(rng() % 800);
+        int value;
+        if (!cache.get(key, value)) {
+            cache.put(key, key);
+        }
+    }
+    EXPECT_EQ(cache.size(), capacity);
+    EXPECT_EQ(cache.hot_size() + cache.cold_size(), capacity);
+    EXPECT_LE(cache.test_size(), capacity);
+    // the cold window keeps 1% of capacity at either end
+    EXPECT_GE(cache.cold_target(), capacity / 100);
+    EXPECT_LE(cache.cold_target(), capacity - capacity / 100);
+}
+
+TEST(ClockProCacheTest, LoopLargerThanCacheMatchesLirs) {
+    // LRU and CLOCK miss every access of a loop past capacity; LIRS keeps
+    // 99% of the cache as a fixed LIR set, and Clock-Pro's hot set should
+    // settle the same way instead of cycling through the loop
+    const int capacity = 1000;
+    ClockProCache<int, int, std::hash<int>> cache(capacity);
+    LIRS::LIRSCache<int, int, std::hash<int>> lirs(capacity);
+    int hits = 0;
+    int lirs_hits = 0;
+    int value;
+    for (int i = 0; i < 20 * capacity; ++i) {
+        int key = i % (capacity * 12 / 10);
+        if (cache.get(key, value)) {
+            ++hits;
+        } else {
+            cache.put(key, key);
+        }
+        if (lirs.get(key).has_value()) {
+            ++lirs_hits;
+        } else {
+            lirs.put(key, key);
+        }
+    }
+    EXPECT_GT(lirs_hits, 20 * capacity * 3 / 4);
+    EXPECT_GE(hits, lirs_hits * 95 / 100);
+    EXPECT_EQ(cache.cold_target(), static_cast<size_t>(capacity / 100));
+}
+
+TEST(ClockProCacheTest, HotSetSurvivesScan) {
+    const int capacity = 100;
+    ClockProCache<int, int, std::hash<int>> cache(capacity);
+    int value;
+    // a small hot set referenced repeatedly becomes hot
+    for (int round = 0; round < 20; ++round) {
+        for (int key = 0; key < 50; ++key) {
+            if (!cache.get(key, value)) {
+                cache.put(key, key);
+            }
+        }
+        // interleaved with one-time keys
+        for (int key = 0; key < 50; ++key) {
+            cache.put(100000 + round * 50 + key, 0);
+        }
+    }
+    int resident = 0;
+    for (int key = 0; key < 50; ++key) {
+        resident += cache.contains(key);
+    }
+    EXPECT_GE(resident, 45);
+}
+
+TEST(ClockProCacheTest, ConcurrentReadersAndWriter) {
+    ClockProCache<int, int, std::hash<int>> cache(128);
+    std::atomic<bool> wrong_value{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &wrong_value, t] {
+            int value;
+            for (int i = 0; i < 20000; ++i) {
+                int key = (i * 13 + t) % 300;
+                if (t == 0) {
+                    cache.put(key, key * 3);
+                } else if (cache.get(key, value)) {
+                    wrong_value = wrong_value || value != key * 3;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(wrong_value);
+    EXPECT_EQ(cache.size(), 128u);
+}
@@ -0,0 +1,187 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 11:32:50
+@Description: 数组环形Clock缓存单元测试 (Google Test)
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include "../include/Clock/clock_ring_cache.h"
+#include "../include/sieve/sieve_shard.h"
+
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ClockRingCacheTest, BasicPutGetRemove) {
+    ClockRingCache<std::string, int> cache(4);
+    cache.put("a", 1);
+    cache.put("b", 2);
+
+    int value = 0;
+    ASSERT_TRUE(cache.get("a", value));
+    EXPECT_EQ(value, 1);
+    EXPECT_FALSE(cache.get("c", value));
+
+    cache.put("a", 10);
+    ASSERT_TRUE(cache.get("a", value));
+    EXPECT_EQ(value, 10);
+    EXPECT_EQ(cache.size(), 2u);
+
+    cache.remove("a");
+    EXPECT_FALSE(cache.contains("a"));
+    EXPECT_EQ(cache.size(), 1u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_THROW((ClockRingCache<int, int>(0)), std::invalid_argument);
+}
+
+TEST(ClockRingCacheTest, SieveModeSparesHitEntries) {
+    ClockRingCache<int, int> cache(3);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+    int value;
+    cache.get(1, value);
+
+    // 1 loses its bit and survives, 2 is the first unreferenced slot
+    cache.put(4, 4);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+
+    // the hand stopped after 2, so 3 goes next rather than 1
+    cache.put(5, 5);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(4));
+    EXPECT_TRUE(cache.contains(5));
+}
+
+TEST(ClockRingCacheTest, ClockModeMarksNewEntries) {
+    ClockRingCache<int, int> cache(3, true);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+
+    // all marked: one turn clears them, then the hand wraps to the first
+    cache.put(4, 4);
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(ClockRingCacheTest, HandCrossesWordBoundaries) {
+    const int n = 200;
+    ClockRingCache<int, int> cache(n);
+    for (int i = 0; i < n; ++i) {
+        cache.put(i, i);
+    }
+    int value;
+    for (int i = 0; i < n; ++i) {
+        if (i != 150) {
+            cache.get(i, value);
+        }
+    }
+
+    // the sweep clears 0..149 and stops at 150, three words in
+    cache.put(n, n);
+    EXPECT_FALSE(cache.contains(150));
+
+    // 151..199 still carry their bits; the newcomer n was appended after
+    // them, so the hand reaches it before wrapping to the cleared 0
+    cache.put(n + 1, n + 1);
+    EXPECT_FALSE(cache.contains(n));
+    EXPECT_TRUE(cache.contains(0));
+    EXPECT_TRUE(cache.contains(151));
+    EXPECT_EQ(cache.size(), static_cast<size_t>(n));
+}
+
+TEST(ClockRingCacheTest, SieveModeReachesNewcomersBeforeSurvivors) {
+    ClockRingCache<int, int> cache(3);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+    int value;
+    cache.get(1, value);
+
+    // 1 survives the first sweep; 4, 5 and 6 are newer than it, so the
+    // hand reaches 4 before wrapping back to 1
+    cache.put(4, 4);
+    cache.put(5, 5);
+    cache.put(6, 6);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(4));
+    EXPECT_TRUE(cache.contains(5));
+    EXPECT_TRUE(cache.contains(6));
+}
+
+TEST(ClockRingCacheTest, SieveModeMatchesLinkedListSieve) {
+    // the list-based SieveShard is the reference; compaction and word
+    // boundaries must not change which keys are evicted
+    const size_t capacity = 150;
+    ClockRingCache<int, int> ring(capacity);
+    Sieve::SieveShard<int, int> list(capacity);
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> key_dist(0, 400);
+    std::uniform_int_distribution<int> op_dist(0, 9);
+    int value;
+    for (int i = 0; i < 50000; ++i) {
+        int key = key_dist(gen);
+        int op = op_dist(gen);
+        if (op < 6) {
+            bool ring_hit = ring.get(key, value);
+            ASSERT_EQ(ring_hit, list.get(key).has_value()) << "step " << i;
+            if (!ring_hit) {
+                ring.put(key, key);
+                list.put(key, key);
+            }
+        } else if (op < 9) {
+            ring.put(key, key);
+            list.put(key, key);
+        } else {
+            ring.remove(key);
+            list.remove(key);
+        }
+        ASSERT_EQ(ring.size(), list.size()) << "step " << i;
+    }
+}
+
+TEST(ClockRingCacheTest, RemovedEntryFreesRoomBeforeEvicting) {
+    ClockRingCache<int, int> cache(2);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.remove(1);
+    cache.put(3, 3);
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+    EXPECT_EQ(cache.size(), 2u);
+}
+
+TEST(ClockRingCacheTest, ConcurrentReadersAndWriter) {
+    ClockRingCache<int, int> cache(128);
+    std::atomic<bool> wrong_value{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &wrong_value, t] {
+            int value;
+            for (int i = 0; i < 20000; ++i) {
+                int key = (i * 13 + t) % 300;
+                if (t == 0) {
+                    cache.put(key, key * 3);
+                } else if (cache.get(key, value)) {
+                    wrong_value = wrong_value || value != key * 3;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(wrong_value);
+    EXPECT_EQ(cache.size(), 128u);
+}
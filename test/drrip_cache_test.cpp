@@ -0,0 +1,103 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-2 22:40:21
+@Description: DRRIP缓存测试套件
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "../include/DRRIP/drrip_cache.h"
+
+using namespace DRRIP;
+
+TEST(DRRIPCacheTest, ConstructorTest) {
+    EXPECT_NO_THROW({
+        DRRIPCache<2> cache(64, 64, 4);
+    });
+
+    EXPECT_THROW({
+        DRRIPCache<2> cache(0, 64, 4);
+    }, std::invalid_argument);
+
+    EXPECT_THROW({
+        DRRIPCache<2> cache(64, 63, 4);
+    }, std::invalid_argument);
+
+    EXPECT_THROW({
+        DRRIPCache<2> cache(64, 64, 4, 0);
+    }, std::invalid_argument);
+
+    // 256 组：每种策略 64 个 leader 时每个 stride 仍有 2 个 follower，
+    // 128 个时所有组都成了 leader
+    EXPECT_NO_THROW({
+        DRRIPCache<2> cache(64, 64, 4, 64);
+    });
+    EXPECT_THROW({
+        DRRIPCache<2> cache(64, 64, 4, 128);
+    }, std::invalid_argument);
+    EXPECT_THROW({
+        DRRIPCache<2> cache(4, 64, 4);
+    }, std::invalid_argument);
+}
+
+TEST(DRRIPCacheTest, BasicAccessTest) {
+    DRRIPCache<2> cache(64, 64, 4);
+
+    EXPECT_FALSE(cache.access(0x1000));
+    EXPECT_EQ(cache.getMissCount(), 1);
+
+    EXPECT_TRUE(cache.access(0x1000));
+    EXPECT_EQ(cache.getHitCount(), 1);
+    EXPECT_EQ(cache.getHitRate(), 50);
+}
+
+TEST(DRRIPCacheTest, ReplacementTest) {
+    DRRIPCache<2> cache(64, 64, 4);
+
+    // 256 组，同一组内的地址间隔为 64 * 256 = 0x4000
+    cache.access(0x0000);
+    cache.access(0x4000);
+    cache.access(0x8000);
+    cache.access(0xC000);
+
+    EXPECT_FALSE(cache.access(0x10000));
+    EXPECT_EQ(cache.getReplaceCount(), 1);
+}
+
+// 循环访问 1.5 倍容量的工作集：SRRIP 颠簸，BRRIP leader 组未命中更少，
+// PSEL 应偏向 BRRIP，follower 组随之切换
+TEST(DRRIPCacheTest, ThrashingWorkloadSelectsBRRIP) {
+    constexpr size_t cache_kb = 256;
+    constexpr size_t block = 64;
+    constexpr size_t ways = 16;
+    const size_t working_set = cache_kb * 1024 / block * 3 / 2;
+
+    DRRIPCache<2> drrip(cache_kb, block, ways);
+
+    for (int round = 0; round < 20; ++round) {
+        for (size_t i = 0; i < working_set; ++i) {
+            drrip.access(i * block);
+        }
+    }
+
+    EXPECT_EQ(drrip.getFollowerPolicy(), InsertionPolicy::BRRIP);
+    EXPECT_GT(drrip.getPsel(), DRRIPCache<2>::PSEL_INIT);
+    EXPECT_GT(drrip.getHitCount(), 0u);
+}
+
+// 工作集小于容量：两种策略都能全部命中，PSEL 不应饱和
+TEST(DRRIPCacheTest, FittingWorkloadHits) {
+    DRRIPCache<2> cache(64, 64, 4);
+    const size_t working_set = 64 * 1024 / 64 / 2;
+
+    for (size_t i = 0; i < working_set; ++i) {
+        cache.access(i * 64);
+    }
+    for (size_t i = 0; i < working_set; ++i) {
+        EXPECT_TRUE(cache.access(i * 64));
+    }
+    EXPECT_LT(cache.getPsel(), DRRIPCache<2>::PSEL_MAX);
+    EXPECT_GT(cache.getPsel(), 0u);
+}
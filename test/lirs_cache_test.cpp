@@ -0,0 +1,172 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 13:35:20
+@Description: LIRS缓存单元测试 (Google Test)
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "../include/LIRS/cache.h"
+#include "../src/LIRS/cache.cpp"
+
+using namespace LIRS;
+
+TEST(LIRSCacheTest, BasicPutGet) {
+    LIRSCache<int, std::string, std::hash<int>> cache(4);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    ASSERT_TRUE(cache.get(1).has_value());
+    EXPECT_EQ(cache.get(1).value(), "one");
+    EXPECT_FALSE(cache.get(3).has_value());
+
+    cache.put(1, "uno");
+    EXPECT_EQ(cache.get(1).value(), "uno");
+    EXPECT_EQ(cache.size(), 2u);
+
+    for (int i = 0; i < 20; ++i) {
+        cache.put(i, std::to_string(i));
+    }
+    EXPECT_EQ(cache.size(), 4u);
+    EXPECT_THROW((LIRSCache<int, int, std::hash<int>>(0)), std::invalid_argument);
+}
+
+TEST(LIRSCacheTest, HirHitInStackIsPromoted) {
+    // capacity 3: two LIR slots, one HIR slot
+    LIRSCache<char, int, std::hash<char>> cache(3);
+    cache.put('A', 1);
+    cache.put('B', 2);
+    cache.put('C', 3);
+    EXPECT_EQ(cache.lir_size(), 2u);
+    EXPECT_EQ(cache.hir_size(), 1u);
+
+    // C is still in S: promoted, the bottom LIR block A is demoted to Q
+    cache.get('C');
+    EXPECT_EQ(cache.lir_size(), 2u);
+    EXPECT_EQ(cache.hir_size(), 1u);
+
+    // A is now the only resident HIR block, so it is the victim
+    cache.put('D', 4);
+    EXPECT_FALSE(cache.contains('A'));
+    EXPECT_TRUE(cache.contains('B'));
+    EXPECT_TRUE(cache.contains('C'));
+    EXPECT_TRUE(cache.contains('D'));
+}
+
+TEST(LIRSCacheTest, HirHitOutOfStackStaysHir) {
+    LIRSCache<char, int, std::hash<char>> cache(3);
+    cache.put('A', 1);
+    cache.put('B', 2);
+    cache.put('C', 3);
+
+    // touching both LIR blocks prunes C off the bottom of S
+    cache.get('A');
+    cache.get('B');
+
+    cache.get('C');
+    EXPECT_EQ(cache.lir_size(), 2u);
+    EXPECT_EQ(cache.hir_size(), 1u);
+
+    cache.put('D', 4);
+    EXPECT_FALSE(cache.contains('C'));
+    EXPECT_TRUE(cache.contains('A'));
+    EXPECT_TRUE(cache.contains('B'));
+}
+
+TEST(LIRSCacheTest, NonResidentHitInStackIsPromoted) {
+    LIRSCache<char, int, std::hash<char>> cache(3);
+    cache.put('A', 1);
+    cache.put('B', 2);
+    cache.put('C', 3);
+
+    // C is evicted but stays in S as history
+    cache.put('D', 4);
+    EXPECT_FALSE(cache.contains('C'));
+    EXPECT_FALSE(cache.get('C').has_value());
+
+    // re-referencing C while in S makes it LIR; A drops to HIR
+    cache.put('C', 5);
+    EXPECT_EQ(cache.get('C').value(), 5);
+    EXPECT_EQ(cache.lir_size(), 2u);
+    EXPECT_FALSE(cache.contains('D'));
+    EXPECT_TRUE(cache.contains('A'));
+    EXPECT_TRUE(cache.contains('B'));
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(LIRSCacheTest, LirBlocksSurviveScans) {
+    LIRSCache<int, int, std::hash<int>> cache(100);
+    for (int round = 0; round < 2; ++round) {
+        for (int key = 0; key < 99; ++key) {
+            cache.put(key, key);
+        }
+    }
+    for (int key = 1000; key < 11000; ++key) {
+        cache.put(key, key);
+    }
+    for (int key = 0; key < 99; ++key) {
+        EXPECT_TRUE(cache.contains(key)) << key;
+    }
+    EXPECT_EQ(cache.size(), 100u);
+}
+
+TEST(LIRSCacheTest, LargeCacheStaysConsistent) {
+    const size_t capacity = 100000;
+    LIRSCache<int, int, std::hash<int>> cache(capacity);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> hot(0, 80000);
+    std::uniform_int_distribution<int> cold(0, 1000000);
+    for (int i = 0; i < 1000000; ++i) {
+        int key = i % 4 == 0 ? cold(rng) : hot(rng);
+        if (!cache.get(key)) {
+            cache.put(key, key);
+        }
+    }
+    EXPECT_EQ(cache.size(), capacity);
+    EXPECT_EQ(cache.lir_size() + cache.hir_size(), capacity);
+}
+
+TEST(LIRSCacheTest, GhostOutOfStackIsNotPromoted) {
+    LIRSCache<char, int, std::hash<char>> cache(3);
+    cache.put('A', 1);
+    cache.put('B', 2);
+    cache.put('C', 3);
+    cache.put('D', 4);  // C becomes a ghost
+    EXPECT_EQ(cache.ghost_size(), 1u);
+
+    // touching both LIR blocks moves the bottom of S above C's recency
+    cache.get('A');
+    cache.get('B');
+
+    // C comes back as a plain HIR block, so it is the next victim, not A
+    cache.put('C', 5);
+    EXPECT_EQ(cache.lir_size(), 2u);
+    EXPECT_EQ(cache.ghost_size(), 0u);
+    cache.put('E', 6);
+    EXPECT_FALSE(cache.contains('C'));
+    EXPECT_TRUE(cache.contains('A'));
+    EXPECT_TRUE(cache.contains('B'));
+}
+
+TEST(LIRSCacheTest, ScanKeepsHistoryBounded) {
+    const size_t capacity = 100;
+    LIRSCache<int, int, std::hash<int>> cache(capacity);
+    for (int key = 0; key < 99; ++key) {
+        cache.put(key, key);
+    }
+    // a long scan of one-time keys: each evicted HIR block would stay in S
+    for (int key = 1000; key < 101000; ++key) {
+        cache.put(key, key);
+        ASSERT_LE(cache.ghost_size(), 2 * capacity);
+    }
+    EXPECT_EQ(cache.size(), capacity);
+
+    // an explicit bound is honoured as well
+    LIRSCache<int, int, std::hash<int>> small_history(capacity, 10);
+    for (int key = 0; key < 10000; ++key) {
+        small_history.put(key, key);
+    }
+    EXPECT_LE(small_history.ghost_size(), 10u);
+}
@@ -0,0 +1,68 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 21:15:44
+@Description: SRRIP/BRRIP按组并行回放测试: 结果须与逐条访问一致
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../include/SRRIP/srrip_cache.h"
+#include "../src/BRRIP/brrip_cache.h"
+
+template <typename Cache>
+class RRIPReplayTest : public ::testing::Test {
+protected:
+    static std::vector<uint64_t> makeTrace(size_t length, uint64_t seed) {
+        std::mt19937_64 gen(seed);
+        std::uniform_int_distribution<uint64_t> dis(0, (1ULL << 12) - 1);
+        std::vector<uint64_t> trace(length);
+        for (auto& addr : trace) {
+            addr = dis(gen) * 64;
+        }
+        return trace;
+    }
+
+    static void expectSameCounts(const Cache& parallel, const Cache& sequential) {
+        EXPECT_EQ(parallel.getHitCount(), sequential.getHitCount());
+        EXPECT_EQ(parallel.getMissCount(), sequential.getMissCount());
+        EXPECT_EQ(parallel.getReplaceCount(), sequential.getReplaceCount());
+    }
+};
+
+using RRIPCaches = ::testing::Types<SRRIP::SRRIPCache<2>, BRRIP::BRRIPCache<2>>;
+TYPED_TEST_SUITE(RRIPReplayTest, RRIPCaches);
+
+TYPED_TEST(RRIPReplayTest, ParallelReplayMatchesSequentialTest) {
+    TypeParam sequential(64, 64, 4);
+    TypeParam parallel(64, 64, 4);
+    const auto trace = this->makeTrace(50000, 7);
+
+    for (auto addr : trace) {
+        sequential.access(addr);
+    }
+    parallel.replay(trace.data(), trace.size(), 4);
+
+    this->expectSameCounts(parallel, sequential);
+    EXPECT_EQ(parallel.getHitCount() + parallel.getMissCount(), trace.size());
+}
+
+TYPED_TEST(RRIPReplayTest, BatchedParallelReplayMatchesSequentialTest) {
+    // 按批回放复用同一组工作线程，非2的幂线程数，结果仍与逐条访问一致
+    TypeParam sequential(64, 64, 4);
+    TypeParam parallel(64, 64, 4);
+    const auto trace = this->makeTrace(60001, 13);
+
+    for (auto addr : trace) {
+        sequential.access(addr);
+    }
+    const size_t batch = 7000;
+    for (size_t begin = 0; begin < trace.size(); begin += batch) {
+        parallel.replay(trace.data() + begin, std::min(batch, trace.size() - begin), 3);
+    }
+
+    this->expectSameCounts(parallel, sequential);
+}
@@ -0,0 +1,183 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 17:08:12
+@Description: Sampled GDSF / Hyperbolic Cache Unit Tests
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include "../include/GDSF/sampled_cache.h"
+#include "../src/GDSF/cache.cpp"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace GDSF;
+using IntSampledCache = SampledGDSFCache<int, std::string, std::hash<int>>;
+
+TEST(SampledGDSFCacheTest, BasicPutGetRemove) {
+    IntSampledCache cache(100);
+    EXPECT_TRUE(cache.put(1, "one", 10));
+    EXPECT_TRUE(cache.put(2, "two", 20));
+    auto result = cache.get(1);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), "one");
+    EXPECT_FALSE(cache.get(3).has_value());
+
+    EXPECT_TRUE(cache.put(1, "uno", 15));
+    EXPECT_EQ(cache.get(1).value(), "uno");
+    EXPECT_EQ(cache.size(), 35u);
+    EXPECT_EQ(cache.count(), 2u);
+
+    EXPECT_TRUE(cache.remove(1));
+    EXPECT_FALSE(cache.remove(1));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_EQ(cache.size(), 20u);
+    EXPECT_FALSE(cache.put(4, "big", 101));
+}
+
+TEST(SampledGDSFCacheTest, SampleCoveringEveryEntryIsExact) {
+    // with no more entries than samples every entry is looked at
+    IntSampledCache cache(100, PriorityMode::GDSF, 16, 0.0);
+    cache.put(1, "f1", 5);
+    cache.put(2, "f2", 5);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(cache.get(1).has_value());
+        EXPECT_TRUE(cache.get(2).has_value());
+    }
+    cache.put(3, "m1", 15);
+    cache.put(4, "m2", 15);
+    cache.put(5, "l1", 25);
+    cache.put(6, "l2", 25);
+
+    EXPECT_TRUE(cache.put(7, "new", 30));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(7));
+    EXPECT_FALSE(cache.contains(5));
+    EXPECT_LE(cache.size(), 100u);
+}
+
+TEST(SampledGDSFCacheTest, HyperbolicRanksByRateNotCount) {
+    IntSampledCache gdsf(2, PriorityMode::GDSF, 8, 0.0);
+    IntSampledCache hyperbolic(2, PriorityMode::Hyperbolic, 8);
+    for (IntSampledCache* cache : {&gdsf, &hyperbolic}) {
+        // key 1: three hits long ago; key 2: just arrived
+        cache->put(1, "old", 1);
+        EXPECT_TRUE(cache->get(1).has_value());
+        EXPECT_TRUE(cache->get(1).has_value());
+        for (int i = 0; i < 1000; ++i) {
+            EXPECT_FALSE(cache->get(100).has_value());
+        }
+        cache->put(2, "new", 1);
+        cache->put(3, "newer", 1);
+    }
+    // GDSF keeps the larger count, hyperbolic the higher rate
+    EXPECT_TRUE(gdsf.contains(1));
+    EXPECT_FALSE(gdsf.contains(2));
+    EXPECT_FALSE(hyperbolic.contains(1));
+    EXPECT_TRUE(hyperbolic.contains(2));
+    EXPECT_EQ(hyperbolic.mode(), PriorityMode::Hyperbolic);
+}
+
+TEST(SampledGDSFCacheTest, HyperbolicPoolIsRankedAtEvictionTime) {
+    IntSampledCache cache(3, PriorityMode::Hyperbolic, 8);
+    cache.put(1, "a", 1);
+    cache.put(2, "b", 1);
+    cache.put(3, "c", 1);
+    // evicts 1, the lowest rate; 2 and 3 stay pooled with their rates now
+    cache.put(4, "d", 1);
+    EXPECT_FALSE(cache.contains(1));
+
+    // 2 turns hot and 4 gets a hit: 3 now has by far the lowest rate,
+    // though it was pooled above 2
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_TRUE(cache.get(2).has_value());
+    }
+    EXPECT_TRUE(cache.get(4).has_value());
+    cache.put(5, "e", 1);
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(4));
+    EXPECT_TRUE(cache.contains(5));
+}
+
+TEST(SampledGDSFCacheTest, GDSFPoolIsRankedAtEvictionTime) {
+    IntSampledCache cache(3, PriorityMode::GDSF, 8);
+    cache.put(1, "a", 1);
+    cache.put(2, "b", 1);
+    cache.put(3, "c", 1);
+    // evicts 1, the first of equals; 2 and 3 stay pooled at 1.5
+    cache.put(4, "d", 1);
+    EXPECT_FALSE(cache.contains(1));
+
+    // 2 turns hot after it was pooled: its pooled priority is stale and
+    // must not make it the next victim
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(cache.get(2).has_value());
+    }
+    cache.put(5, "e", 1);
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_TRUE(cache.contains(4));
+    EXPECT_TRUE(cache.contains(5));
+}
+
+TEST(SampledGDSFCacheTest, RandomOperationsKeepAccounting) {
+    IntSampledCache cache(1000, PriorityMode::Hyperbolic);
+    std::unordered_map<int, size_t> sizes;
+    std::mt19937 rng(42);
+    for (int i = 0; i < 50000; ++i) {
+        int key = static_cast<int>(rng() % 500);
+        if (rng() % 3 == 0) {
+            size_t size = 1 + rng() % 40;
+            ASSERT_TRUE(cache.put(key, std::to_string(key), size));
+            sizes[key] = size;
+        } else if (rng() % 8 == 0) {
+            cache.remove(key);
+        } else if (auto result = cache.get(key)) {
+            EXPECT_EQ(result.value(), std::to_string(key));
+        }
+    }
+
+    size_t total = 0;
+    size_t resident = 0;
+    for (const auto& [key, size] : sizes) {
+        if (cache.contains(key)) {
+            total += size;
+            ++resident;
+        }
+    }
+    EXPECT_EQ(cache.size(), total);
+    EXPECT_EQ(cache.count(), resident);
+    EXPECT_LE(cache.size(), 1000u);
+}
+
+TEST(SampledGDSFCacheTest, HitRatioCloseToExactHeap) {
+    const size_t capacity = 20000;
+    GDSFCache<int, std::string, std::hash<int>> exact(capacity);
+    IntSampledCache sampled(capacity);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    size_t exact_hits = 0;
+    size_t sampled_hits = 0;
+    for (int i = 0; i < 200000; ++i) {
+        int key = static_cast<int>(std::pow(uniform(rng), 3.0) * 50000);
+        size_t size = 1 + static_cast<size_t>(key) * 2654435761u % 64;
+        if (exact.get(key)) {
+            ++exact_hits;
+        } else {
+            exact.put(key, "v", size);
+        }
+        if (sampled.get(key)) {
+            ++sampled_hits;
+        } else {
+            sampled.put(key, "v", size);
+        }
+    }
+    EXPECT_GE(sampled_hits, exact_hits * 90 / 100);
+}
@@ -0,0 +1,177 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 16:30:54
+@Description: Sharded GDSF Cache Unit Tests
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include "../include/GDSF/sharded_cache.h"
+#include "../src/GDSF/cache.cpp"
+
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace GDSF;
+using IntShardedCache = ShardedGDSFCache<int, std::string, std::hash<int>>;
+
+namespace {
+
+size_t shardBytes(const IntShardedCache& cache) {
+    size_t total = 0;
+    for (size_t i = 0; i < cache.shard_count(); ++i) {
+        total += cache.shard(i).size();
+    }
+    return total;
+}
+
+} // namespace
+
+TEST(ShardedGDSFCacheTest, BasicPutGetRemove) {
+    IntShardedCache cache(100, 4);
+    EXPECT_TRUE(cache.put(1, "one", 10));
+    EXPECT_TRUE(cache.put(2, "two", 20));
+    auto result = cache.get(1);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), "one");
+    EXPECT_FALSE(cache.get(3).has_value());
+
+    EXPECT_TRUE(cache.put(1, "uno", 15));
+    EXPECT_EQ(cache.get(1).value(), "uno");
+    EXPECT_EQ(cache.size(), 35u);
+    EXPECT_EQ(cache.count(), 2u);
+
+    EXPECT_TRUE(cache.remove(1));
+    EXPECT_FALSE(cache.remove(1));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_EQ(cache.size(), 20u);
+}
+
+TEST(ShardedGDSFCacheTest, RejectsZeroCapacityAndOversizedItems) {
+    EXPECT_THROW((IntShardedCache(0)), std::invalid_argument);
+    IntShardedCache cache(50, 2);
+    EXPECT_FALSE(cache.put(1, "big", 51));
+    EXPECT_TRUE(cache.put(2, "fits", 50));
+    EXPECT_EQ(cache.shard_count(), 2u);
+}
+
+TEST(ShardedGDSFCacheTest, CapacityIsAGlobalByteBudget) {
+    IntShardedCache cache(1000, 8);
+    std::mt19937 rng(3);
+    for (int i = 0; i < 20000; ++i) {
+        int key = static_cast<int>(rng() % 2000);
+        ASSERT_TRUE(cache.put(key, std::to_string(key), 1 + rng() % 50));
+        ASSERT_LE(cache.size(), cache.capacity());
+    }
+    EXPECT_EQ(shardBytes(cache), cache.size());
+
+    // every shard evicted at some point, so each L moved off its start
+    for (size_t i = 0; i < cache.shard_count(); ++i) {
+        EXPECT_GT(cache.shard(i).l_value(), 0.5);
+    }
+}
+
+TEST(ShardedGDSFCacheTest, FullSampleKeepsSmallFrequentItems) {
+    // sampling every shard picks the true per-shard minima
+    IntShardedCache cache(100, 4, 0.0, 4);
+    cache.put(1, "f1", 5);
+    cache.put(2, "f2", 5);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(cache.get(1).has_value());
+        EXPECT_TRUE(cache.get(2).has_value());
+    }
+    cache.put(3, "m1", 15);
+    cache.put(4, "m2", 15);
+    cache.put(5, "l1", 25);
+    cache.put(6, "l2", 25);
+
+    EXPECT_TRUE(cache.put(7, "new", 30));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_TRUE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(7));
+    EXPECT_LE(cache.size(), 100u);
+}
+
+TEST(ShardedGDSFCacheTest, GrowingKeyEvictsColdEntriesNotHotShard) {
+    // small integers map to shard key % 4
+    IntShardedCache cache(100, 4, 0.5, 1);
+    for (int key = 0; key < 20; ++key) {
+        ASSERT_TRUE(cache.put(key, "v", 5));
+    }
+    for (int key = 0; key < 20; key += 4) {
+        for (int i = 0; i < 50; ++i) {
+            EXPECT_TRUE(cache.get(key).has_value());
+        }
+    }
+
+    // key 3 grows by 25 bytes with the budget full: shard 3's other 20
+    // bytes go first, then the lowest minimum elsewhere, never shard 0's
+    ASSERT_TRUE(cache.put(3, "grown", 30));
+    EXPECT_EQ(cache.get(3).value(), "grown");
+    for (int key = 0; key < 20; key += 4) {
+        EXPECT_TRUE(cache.contains(key)) << key;
+    }
+    for (int key = 7; key < 20; key += 4) {
+        EXPECT_FALSE(cache.contains(key)) << key;
+    }
+    EXPECT_EQ(cache.count(), 15u);
+    EXPECT_EQ(cache.size(), 100u);
+    EXPECT_EQ(shardBytes(cache), cache.size());
+}
+
+TEST(ShardedGDSFCacheTest, HitRatioCloseToSingleHeap) {
+    const size_t capacity = 20000;
+    GDSFCache<int, std::string, std::hash<int>> single(capacity);
+    IntShardedCache sharded(capacity, 16);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    size_t single_hits = 0;
+    size_t sharded_hits = 0;
+    for (int i = 0; i < 200000; ++i) {
+        // skewed popularity, sizes uncorrelated with popularity
+        int key = static_cast<int>(std::pow(uniform(rng), 3.0) * 50000);
+        size_t size = 1 + static_cast<size_t>(key) * 2654435761u % 64;
+        if (single.get(key)) {
+            ++single_hits;
+        } else {
+            single.put(key, "v", size);
+        }
+        if (sharded.get(key)) {
+            ++sharded_hits;
+        } else {
+            sharded.put(key, "v", size);
+        }
+    }
+    EXPECT_GE(sharded_hits, single_hits * 95 / 100);
+}
+
+TEST(ShardedGDSFCacheTest, ConcurrentReadersAndWriters) {
+    IntShardedCache cache(4000, 8);
+    std::atomic<bool> wrong_value{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &wrong_value, t] {
+            for (int i = 0; i < 20000; ++i) {
+                int key = (i * 7 + t) % 1024;
+                if ((t == 0 && i % 4 == 0) || (t == 2 && i % 2 == 0)) {
+                    cache.put(key, std::to_string(key), 1 + key % 32);
+                } else if (t == 1 && i % 16 == 0) {
+                    cache.remove(key);
+                } else if (auto value = cache.get(key)) {
+                    wrong_value = wrong_value || *value != std::to_string(key);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(wrong_value);
+    EXPECT_LE(cache.size(), cache.capacity());
+    EXPECT_EQ(shardBytes(cache), cache.size());
+}
@@ -0,0 +1,226 @@
+/*
+@Author: Lzww
+@LastEditTime: 2026-10-16 10:40:12
+@Description: Concurrent and Sharded Sieve Cache Unit Tests
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include "../include/sieve/sieve_shard.h"
+#include "../include/sieve/sharded_cache.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Sieve;
+
+TEST(SieveShardTest, BasicPutGetRemove) {
+    SieveShard<int, std::string> cache(4);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    ASSERT_TRUE(cache.get(1).has_value());
+    EXPECT_EQ(cache.get(1).value(), "one");
+    EXPECT_FALSE(cache.get(3).has_value());
+
+    cache.put(1, "uno");
+    EXPECT_EQ(cache.get(1).value(), "uno");
+    EXPECT_EQ(cache.size(), 2u);
+
+    EXPECT_TRUE(cache.remove(1));
+    EXPECT_FALSE(cache.remove(1));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(SieveShardTest, ZeroCapacityThrows) {
+    EXPECT_THROW((SieveShard<int, int>(0)), std::invalid_argument);
+}
+
+TEST(SieveShardTest, VisitedEntriesSurviveEviction) {
+    SieveShard<int, int> cache(3);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+    cache.get(1);
+
+    // the hand starts at the oldest entry: 1 is visited and spared, 2 goes
+    cache.put(4, 4);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+
+    // the hand resumes after 2, so 3 goes next, not the unvisited 1
+    cache.put(5, 5);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(SieveShardTest, NeverExceedsCapacity) {
+    SieveShard<int, int> cache(100);
+    for (int i = 0; i < 1000; ++i) {
+        cache.put(i, i);
+    }
+    EXPECT_EQ(cache.size(), 100u);
+    for (int i = 900; i < 1000; ++i) {
+        EXPECT_TRUE(cache.contains(i));
+    }
+}
+
+TEST(SieveShardTest, ConcurrentReadersAndWriters) {
+    SieveShard<int, int> cache(256);
+    for (int i = 0; i < 128; ++i) {
+        cache.put(i, i * 10);
+    }
+
+    std::atomic<bool> wrong_value{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &wrong_value, t] {
+            for (int i = 0; i < 20000; ++i) {
+                int key = (i * 7 + t) % 512;
+                if (t == 0 && i % 4 == 0) {
+                    cache.put(key, key * 10);
+                } else if (t == 1 && i % 16 == 0) {
+                    cache.remove(key);
+                } else if (auto value = cache.get(key)) {
+                    wrong_value = wrong_value || *value != key * 10;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(wrong_value);
+    EXPECT_LE(cache.size(), cache.capacity());
+}
+
+TEST(ShardedSieveCacheTest, BasicPutGetDel) {
+    ShardedSieveCache<int, std::string> cache(4, 1);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    ASSERT_TRUE(cache.get(1).has_value());
+    EXPECT_EQ(cache.get(1).value(), "one");
+    EXPECT_FALSE(cache.get(3).has_value());
+
+    cache.put(1, "uno");
+    EXPECT_EQ(cache.get(1).value(), "uno");
+    EXPECT_EQ(cache.size(), 2u);
+
+    EXPECT_TRUE(cache.del(1));
+    EXPECT_FALSE(cache.del(1));
+    EXPECT_FALSE(cache.contains(1));
+    EXPECT_EQ(cache.size(), 1u);
+}
+
+TEST(ShardedSieveCacheTest, ZeroCapacityThrows) {
+    EXPECT_THROW((ShardedSieveCache<int, int>(0)), std::invalid_argument);
+}
+
+TEST(ShardedSieveCacheTest, VisitedEntriesSurviveEviction) {
+    ShardedSieveCache<int, int> cache(3, 1);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);
+    cache.get(1);
+
+    // the hand starts at the oldest entry: 1 is visited and spared, 2 goes
+    cache.put(4, 4);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(3));
+
+    // the hand resumes after 2, so 3 goes next, not the unvisited 1
+    cache.put(5, 5);
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_FALSE(cache.contains(3));
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(ShardedSieveCacheTest, CapacityIsAGlobalBudget) {
+    ShardedSieveCache<int, int> cache(100, 8);
+    EXPECT_EQ(cache.shard_count(), 8u);
+    for (int i = 0; i < 1000; ++i) {
+        cache.put(i, i);
+    }
+    EXPECT_EQ(cache.size(), 100u);
+
+    size_t total = 0;
+    for (size_t shard = 0; shard < cache.shard_count(); ++shard) {
+        total += cache.shard_size(shard);
+    }
+    EXPECT_EQ(total, 100u);
+
+    // tiny capacities get fewer shards instead of over-provisioning
+    ShardedSieveCache<int, int> small(3, 16);
+    EXPECT_EQ(small.shard_count(), 2u);
+    for (int i = 0; i < 10; ++i) {
+        small.put(i, i);
+    }
+    EXPECT_EQ(small.size(), 3u);
+}
+
+TEST(ShardedSieveCacheTest, HotShardBorrowsFromColdOnes) {
+    // identity-like hashing: keys that are multiples of 4 land in shard 0
+    ShardedSieveCache<int, int> cache(40, 4);
+    for (int i = 0; i < 40; ++i) {
+        cache.put(i * 4, i);
+    }
+    // one shard holds the whole budget instead of capping at its share of 10
+    EXPECT_EQ(cache.size(), 40u);
+    for (int i = 0; i < 40; ++i) {
+        EXPECT_TRUE(cache.contains(i * 4));
+    }
+
+    // cold shards take their share back as they fill up
+    for (int i = 0; i < 10; ++i) {
+        cache.put(i * 4 + 1, i);
+    }
+    EXPECT_EQ(cache.size(), 40u);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(cache.contains(i * 4 + 1));
+    }
+
+    // the hot shard now evicts from itself
+    cache.put(1000, 0);
+    EXPECT_EQ(cache.size(), 40u);
+    EXPECT_TRUE(cache.contains(1000));
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(cache.contains(i * 4 + 1));
+    }
+
+    EXPECT_TRUE(cache.del(1000));
+    EXPECT_EQ(cache.size(), 39u);
+}
+
+TEST(ShardedSieveCacheTest, ConcurrentReadersAndWriters) {
+    ShardedSieveCache<int, int> cache(256, 4);
+    for (int i = 0; i < 128; ++i) {
+        cache.put(i, i * 10);
+    }
+
+    std::atomic<bool> wrong_value{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, &wrong_value, t] {
+            for (int i = 0; i < 20000; ++i) {
+                int key = (i * 7 + t) % 512;
+                if ((t == 0 && i % 4 == 0) || (t == 2 && i % 2 == 0)) {
+                    cache.put(key, key * 10);
+                } else if (t == 1 && i % 16 == 0) {
+                    cache.del(key);
+                } else if (auto value = cache.get(key)) {
+                    wrong_value = wrong_value || *value != key * 10;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(wrong_value);
+    EXPECT_LE(cache.size(), cache.capacity());
+}
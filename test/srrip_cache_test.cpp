@@ -109,6 +109,24 @@ TEST_F(SRRIPCacheTest, ConcurrentAccessTest) {
     EXPECT_EQ(total, num_threads * ops_per_thread);
 }
 
+TEST_F(SRRIPCacheTest, MetadataOnlyMatchesFullLineTest) {
+    static_assert(sizeof(CompactCacheLine) < sizeof(CacheLine), "compact line must be smaller");
+
+    SRRIPCache<2> full(64, 64, 4);
+    SRRIPCache<2, true> compact(64, 64, 4);
+
+    std::mt19937_64 gen(11);
+    std::uniform_int_distribution<uint64_t> dis(0, (1ULL << 12) - 1);
+    for (int i = 0; i < 50000; ++i) {
+        uint64_t addr = dis(gen) * 64;
+        EXPECT_EQ(compact.access(addr), full.access(addr));
+    }
+
+    EXPECT_EQ(compact.getHitCount(), full.getHitCount());
+    EXPECT_EQ(compact.getMissCount(), full.getMissCount());
+    EXPECT_EQ(compact.getReplaceCount(), full.getReplaceCount());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -11,6 +11,8 @@
 #include <random>
 #include <string>
 #include <iostream>
+#include <atomic>
+#include <unordered_map>
 
 // 添加CRP命名空间声明
 namespace CRP {}
@@ -124,9 +126,9 @@ TEST_F(GDSFCacheTest, GDSFPriorityCalculation) {
     EXPECT_EQ(test_cache.size(), 16);
     
     // 访问medium和large，增加它们的频率
-    test_cache.get("medium");  // 频率变为2，优先级 = 0 + 2/5 = 0.4
-    test_cache.get("large");   // 频率变为2，优先级 = 0 + 2/10 = 0.2
-    test_cache.get("large");   // 频率变为3，优先级 = 0 + 3/10 = 0.3
+    EXPECT_TRUE(test_cache.get("medium").has_value());  // 频率变为2，优先级 = 0 + 2/5 = 0.4
+    EXPECT_TRUE(test_cache.get("large").has_value());   // 频率变为2，优先级 = 0 + 2/10 = 0.2
+    EXPECT_TRUE(test_cache.get("large").has_value());   // 频率变为3，优先级 = 0 + 3/10 = 0.3
     
     // 插入大项目，触发驱逐
     test_cache.put("huge", "h", 90);
@@ -145,7 +147,7 @@ TEST_F(GDSFCacheTest, FrequencyUpdateOnGet) {
     
     // 多次访问key1，增加其频率
     for(int i = 0; i < 5; i++) {
-        test_cache.get("key1");
+        EXPECT_TRUE(test_cache.get("key1").has_value());
     }
     // key1频率现在为6，优先级 = 0 + 6/10 = 0.6
     
@@ -259,16 +261,16 @@ TEST_F(GDSFCacheTest, ComplexEvictionScenario) {
     test_cache.put("freq1", "v1", 5);
     test_cache.put("freq2", "v2", 5);
     for(int i = 0; i < 10; i++) {
-        test_cache.get("freq1");
-        test_cache.get("freq2");
+        EXPECT_TRUE(test_cache.get("freq1").has_value());
+        EXPECT_TRUE(test_cache.get("freq2").has_value());
     }
     
     // 第二批：中等大小，中等频率
     test_cache.put("med1", "v3", 15);
     test_cache.put("med2", "v4", 15);
     for(int i = 0; i < 3; i++) {
-        test_cache.get("med1");
-        test_cache.get("med2");
+        EXPECT_TRUE(test_cache.get("med1").has_value());
+        EXPECT_TRUE(test_cache.get("med2").has_value());
     }
     
     // 第三批：大而很少访问
@@ -311,7 +313,7 @@ TEST_F(GDSFCacheTest, ConcurrentAccess) {
                 
                 // 随机读取
                 if(i % 2 == 0) {
-                    thread_cache.get(key);
+                    (void)thread_cache.get(key);  // 只为制造并发读，结果无关
                 }
             }
         });
@@ -340,8 +342,8 @@ TEST_F(GDSFCacheTest, LValueUpdateAfterEviction) {
     test_cache.put("item2", "v2", 20);  // 优先级 = 0 + 1/20 = 0.05
     
     // 访问item1几次，提高其优先级
-    test_cache.get("item1");  // 频率=2，优先级 = 0 + 2/25 = 0.08
-    test_cache.get("item1");  // 频率=3，优先级 = 0 + 3/25 = 0.12
+    EXPECT_TRUE(test_cache.get("item1").has_value());  // 频率=2，优先级 = 0 + 2/25 = 0.08
+    EXPECT_TRUE(test_cache.get("item1").has_value());  // 频率=3，优先级 = 0 + 3/25 = 0.12
     
     EXPECT_EQ(test_cache.size(), 45);
     
@@ -356,6 +358,80 @@ TEST_F(GDSFCacheTest, LValueUpdateAfterEviction) {
     // 这个测试主要验证驱逐逻辑不会崩溃
 }
 
+// ============== 索引堆测试 ==============
+
+TEST_F(GDSFCacheTest, HitsProtectFromEviction) {
+    StringCache test_cache(30, 0.0);
+    test_cache.put("a", "va", 10);
+    test_cache.put("b", "vb", 10);
+    test_cache.put("c", "vc", 10);
+
+    // a的优先级只在节点上提高, 堆中旧键等到堆顶时再修正
+    EXPECT_TRUE(test_cache.get("a").has_value());
+    EXPECT_TRUE(test_cache.get("a").has_value());
+
+    test_cache.put("d", "vd", 10);
+    test_cache.put("e", "ve", 10);
+
+    EXPECT_TRUE(test_cache.contains("a"));
+    EXPECT_FALSE(test_cache.contains("b"));
+    EXPECT_FALSE(test_cache.contains("c"));
+    EXPECT_TRUE(test_cache.contains("d"));
+    EXPECT_TRUE(test_cache.contains("e"));
+    EXPECT_EQ(test_cache.count(), 3);
+}
+
+TEST_F(GDSFCacheTest, ResizeExistingKey) {
+    StringCache test_cache(100, 0.0);
+    test_cache.put("a", "v1", 10);
+    test_cache.put("b", "v2", 10);
+
+    // 原地缩小/放大, 不需要驱逐
+    EXPECT_TRUE(test_cache.put("a", "v3", 5));
+    EXPECT_EQ(test_cache.size(), 15);
+    EXPECT_TRUE(test_cache.put("a", "v4", 60));
+    EXPECT_EQ(test_cache.size(), 70);
+
+    // 放大到放不下, 只能驱逐b
+    EXPECT_TRUE(test_cache.put("a", "v5", 95));
+    EXPECT_EQ(test_cache.size(), 95);
+    EXPECT_FALSE(test_cache.contains("b"));
+    auto result = test_cache.get("a");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result.value(), "v5");
+}
+
+TEST_F(GDSFCacheTest, RandomOperationsKeepAccounting) {
+    IntCache test_cache(1000, 0.0);
+    std::unordered_map<int, size_t> sizes;
+    std::mt19937 rng(42);
+    for (int i = 0; i < 50000; ++i) {
+        int key = static_cast<int>(rng() % 500);
+        if (rng() % 3 == 0) {
+            size_t size = 1 + rng() % 40;
+            ASSERT_TRUE(test_cache.put(key, std::to_string(key), size));
+            sizes[key] = size;
+        } else {
+            auto result = test_cache.get(key);
+            if (result.has_value()) {
+                EXPECT_EQ(result.value(), std::to_string(key));
+            }
+        }
+    }
+
+    size_t total = 0;
+    int resident = 0;
+    for (const auto& [key, size] : sizes) {
+        if (test_cache.contains(key)) {
+            total += size;
+            ++resident;
+        }
+    }
+    EXPECT_EQ(test_cache.size(), total);
+    EXPECT_EQ(test_cache.count(), resident);
+    EXPECT_LE(test_cache.size(), 1000);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,216 @@
+/*
+@Author: Lzww
+@LastEditTime: 2025-11-6 21:05:12
+@Description: trace 读取测试套件
+@Language: C++17
+*/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "../include/trace/trace_reader.h"
+
+using namespace Trace;
+
+class TraceReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        prefix_ = "/tmp/crp_trace_test_" + std::to_string(::getpid());
+        for (uint64_t i = 0; i < 100003; ++i) {
+            addresses_.push_back(i * 64 + (i % 7));
+        }
+    }
+
+    void TearDown() override {
+        for (const auto& path : created_) {
+            std::remove(path.c_str());
+        }
+    }
+
+    std::string writeRaw(const std::vector<uint64_t>& addrs) {
+        std::string path = prefix_ + ".bin";
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(addrs.data()), addrs.size() * sizeof(uint64_t));
+        created_.push_back(path);
+        return path;
+    }
+
+    static std::vector<uint64_t> readAll(TraceReader& reader) {
+        std::vector<uint64_t> result;
+        const uint64_t* batch = nullptr;
+        size_t n;
+        while ((n = reader.nextBatch(batch)) > 0) {
+            result.insert(result.end(), batch, batch + n);
+        }
+        return result;
+    }
+
+    std::string prefix_;
+    std::vector<uint64_t> addresses_;
+    std::vector<std::string> created_;
+};
+
+TEST_F(TraceReaderTest, MappedReaderReturnsAllAddresses) {
+    std::string path = writeRaw(addresses_);
+    MappedTraceReader reader(path, 4096);
+
+    EXPECT_EQ(reader.size(), addresses_.size());
+    EXPECT_EQ(readAll(reader), addresses_);
+
+    const uint64_t* batch = nullptr;
+    EXPECT_EQ(reader.nextBatch(batch), 0u);
+}
+
+TEST_F(TraceReaderTest, MappedReaderEmptyFile) {
+    std::string path = writeRaw({});
+    MappedTraceReader reader(path);
+
+    EXPECT_EQ(reader.size(), 0u);
+    EXPECT_TRUE(readAll(reader).empty());
+}
+
+TEST_F(TraceReaderTest, RejectsPartialAddress) {
+    std::string path = prefix_ + ".odd";
+    std::ofstream(path, std::ios::binary) << "abc";
+    created_.push_back(path);
+
+    EXPECT_THROW(MappedTraceReader reader(path), std::runtime_error);
+    EXPECT_THROW(MappedTraceReader reader(prefix_ + ".missing"), std::runtime_error);
+}
+
+// 内存解码器：按固定小块返回字节，模拟解压流
+class ChunkedDecoder : public StreamDecoder {
+public:
+    ChunkedDecoder(std::vector<uint64_t> addrs, size_t chunk, bool fail_at_end = false)
+        : bytes_(reinterpret_cast<const char*>(addrs.data()),
+                 reinterpret_cast<const char*>(addrs.data()) + addrs.size() * sizeof(uint64_t)),
+          chunk_(chunk), fail_at_end_(fail_at_end) {}
+
+    size_t read(void* dst, size_t len) override {
+        size_t n = std::min({len, chunk_, bytes_.size() - pos_});
+        if (n == 0 && fail_at_end_) {
+            throw std::runtime_error("decode failure");
+        }
+        std::memcpy(dst, bytes_.data() + pos_, n);
+        pos_ += n;
+        return n;
+    }
+
+private:
+    std::string bytes_;
+    size_t pos_{0};
+    size_t chunk_;
+    bool fail_at_end_;
+};
+
+TEST_F(TraceReaderTest, StreamingReaderDoubleBuffers) {
+    // chunk 不是 8 的倍数，批大小也不整除总数
+    StreamingTraceReader reader(std::make_unique<ChunkedDecoder>(addresses_, 1000), 4096);
+
+    EXPECT_EQ(readAll(reader), addresses_);
+
+    const uint64_t* batch = nullptr;
+    EXPECT_EQ(reader.nextBatch(batch), 0u);
+}
+
+TEST_F(TraceReaderTest, StreamingReaderPropagatesDecodeError) {
+    StreamingTraceReader reader(std::make_unique<ChunkedDecoder>(addresses_, 1 << 16, true), 4096);
+
+    EXPECT_THROW(readAll(reader), std::runtime_error);
+}
+
+TEST_F(TraceReaderTest, StreamingReaderEarlyDestruction) {
+    // 只消费一批即析构，解码线程必须能退出
+    StreamingTraceReader reader(std::make_unique<ChunkedDecoder>(addresses_, 1 << 16), 1024);
+    const uint64_t* batch = nullptr;
+    EXPECT_EQ(reader.nextBatch(batch), 1024u);
+    EXPECT_EQ(batch[0], addresses_[0]);
+}
+
+#ifdef HAVE_ZLIB
+TEST_F(TraceReaderTest, GzipTraceViaOpenTrace) {
+    std::string path = prefix_ + ".bin.gz";
+    gzFile gz = gzopen(path.c_str(), "wb");
+    ASSERT_NE(gz, nullptr);
+    gzwrite(gz, addresses_.data(), static_cast<unsigned>(addresses_.size() * sizeof(uint64_t)));
+    gzclose(gz);
+    created_.push_back(path);
+
+    auto reader = openTrace(path);
+    EXPECT_EQ(readAll(*reader), addresses_);
+
+    // 截断的gzip流必须报错, 而不是静默丢掉尾部
+    std::ifstream in(path, std::ios::binary);
+    std::string compressed((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::string cut = prefix_ + ".cut.gz";
+    std::ofstream(cut, std::ios::binary) << compressed.substr(0, compressed.size() - 16);
+    created_.push_back(cut);
+    auto truncated = openTrace(cut);
+    EXPECT_THROW(readAll(*truncated), std::runtime_error);
+}
+#endif
+
+#ifdef HAVE_ZSTD
+TEST_F(TraceReaderTest, ZstdRoundTripKeepsPartialFinalBatch) {
+    const size_t bytes = addresses_.size() * sizeof(uint64_t);
+    std::vector<char> frame(ZSTD_compressBound(bytes));
+    size_t n = ZSTD_compress(frame.data(), frame.size(), addresses_.data(), bytes, 3);
+    ASSERT_FALSE(ZSTD_isError(n));
+
+    std::string path = prefix_ + ".bin.zst";
+    std::ofstream(path, std::ios::binary).write(frame.data(), static_cast<std::streamsize>(n));
+    created_.push_back(path);
+
+    auto reader = openTrace(path);
+    EXPECT_EQ(readAll(*reader), addresses_);
+}
+
+TEST_F(TraceReaderTest, ZstdConcatenatedFramesAndTruncation) {
+    const size_t half = addresses_.size() / 2;
+    std::string compressed;
+    for (size_t begin : {size_t{0}, half}) {
+        size_t end = begin == 0 ? half : addresses_.size();
+        size_t bytes = (end - begin) * sizeof(uint64_t);
+        std::vector<char> frame(ZSTD_compressBound(bytes));
+        size_t n = ZSTD_compress(frame.data(), frame.size(), addresses_.data() + begin, bytes, 3);
+        ASSERT_FALSE(ZSTD_isError(n));
+        compressed.append(frame.data(), n);
+    }
+
+    std::string path = prefix_ + ".two.zst";
+    std::ofstream(path, std::ios::binary) << compressed;
+    created_.push_back(path);
+    auto reader = openTrace(path);
+    EXPECT_EQ(readAll(*reader), addresses_);
+
+    // 截掉最后一帧的尾部
+    std::string cut = prefix_ + ".cut.zst";
+    std::ofstream(cut, std::ios::binary) << compressed.substr(0, compressed.size() - 16);
+    created_.push_back(cut);
+    auto truncated = openTrace(cut);
+    EXPECT_THROW(readAll(*truncated), std::runtime_error);
+}
+#endif
+
+TEST_F(TraceReaderTest, OpenTraceUsesMmapForRawFiles) {
+    std::string path = writeRaw(addresses_);
+    auto reader = openTrace(path);
+
+    EXPECT_NE(dynamic_cast<MappedTraceReader*>(reader.get()), nullptr);
+    EXPECT_EQ(readAll(*reader), addresses_);
+}